@@ -1,19 +1,38 @@
+#include <atomic>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
-#include <fstream>
+#include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
-void dumpFile(const std::string& path) {
-    std::ifstream fin(path);
-    if (!fin.is_open()) {
-        std::cerr << "[Compiler] Cannot open " << path << "\n";
-        return;
-    }
-    std::string line;
-    while (std::getline(fin, line)) {
-        std::cerr << line << "\n";
-    }
-}
+// 词法分析器（liblexer.a）
+#include "lexer.h"
+#include "lexer_generator.h"
+#include "dfa_table.h"
+#include "simd_scan.h"
+#include "source_file.h"
+
+// 语法分析器（头文件实现）
+#include "FirstFollowCalculator.hpp"
+#include "LRAutomaton.hpp"
+#include "SLRAnalysisTable.hpp"
+#include "ShiftReduceParser.hpp"
+
+#include "spsc_queue.h"
+
+/*
+ * LexItem
+ * =======
+ * 词法线程交给语法线程的 token
+ * lexeme 不拷贝：两边共享同一份源文件映射，只传偏移和长度
+ */
+struct LexItem {
+    TokenType type = TokenType::ENDFILE;
+    uint32_t offset = 0;
+    uint32_t length = 0;
+};
 
 int main(int argc, char* argv[]) {
     if (argc != 4) {
@@ -27,31 +46,144 @@ int main(int argc, char* argv[]) {
     std::string lex     = argv[2];
     std::string grammar = argv[3];
 
-    // lexer 实际生成的 token 文件（相对于 Compiler/）
-    std::string tokenFile = "output.txt";
+    try {
+        // ===== 1. 构造词法分析器 =====
+        // 转移表走与 lexer_gen 相同的磁盘缓存
+        const char* envCache = std::getenv("LEXER_CACHE_DIR");
+        std::string cacheDir = envCache ? envCache : ".lexer_cache";
 
-    // ===== 1. 运行词法分析器 =====
-    std::string lexerCmd =
-        "..\\Lexical_analyzer\\lexer_gen.exe " +
-        source + " " + lex;
+        LexerGenerator gen;
+        gen.loadRuleFile(lex);
+        DFATable table = gen.buildTable(cacheDir);
 
-    std::cout << "[Compiler] Running lexer:\n  " << lexerCmd << "\n";
-    int ret = std::system(lexerCmd.c_str());
-    if (ret != 0) {
-        std::cerr << "[Compiler] Lexer failed. Dumping output.txt for diagnosis:\n";
-        dumpFile(tokenFile);
-        return 1;
-    }
+        // ===== 2. 构造语法分析器 =====
+        GrammarLoader loader;
+        GrammarDefinition def = loader.LoadFromFile(grammar);
+        if (def.Productions.empty()) {
+            std::cerr << "[Compiler] Cannot load grammar " << grammar << "\n";
+            return 1;
+        }
+
+        FirstFollowCalculator ff(def);
+        ff.Calculate();
+        LRAutomatonBuilder automaton(def);
+        FirstFollowCalculator augmentedFF(automaton.AugmentedGrammar);
+        augmentedFF.Calculate();
+        SLRAnalysisTableBuilder slrTable(automaton, augmentedFF);
+        ShiftReduceParser parser(slrTable);
+
+        // Token 种类一次性绑定到终结符编号，之后 token 以整数直达分析表
+        const TokenKinds& kinds = table.kinds;
+        std::vector<int> terminalOf =
+            slrTable.BindTokenKinds(kinds.names, kinds.literals);
+
+        // ===== 3. 词法 / 语法流水线 =====
+        // 词法线程边扫描边入队，语法分析在主线程按需出队，
+        // 不再经过 output.txt，也不需要先收集整个 token 序列
+        SourceFile code(source);
+        std::string_view text = code.view();
+        parser.Lines = buildLineIndex(text);
 
-    // ===== 2. 运行语法分析器 =====
-    std::string parserCmd =
-        "..\\Syntactic_analyzer\\SyntacticAnalyzer.exe " +
-        grammar + " " + tokenFile;
+        // Lexer 在主线程构造：构造失败（如源文件过大）的异常走下面的 catch，
+        // 而不是在词法线程里直接终止进程
+        Lexer lexer(text, table);
 
-    std::cout << "[Compiler] Running parser:\n  " << parserCmd << "\n";
-    ret = std::system(parserCmd.c_str());
-    if (ret != 0) {
-        std::cerr << "[Compiler] Parser failed.\n";
+        SpscQueue<LexItem> queue(4096);
+        std::atomic<bool> stop{false};
+
+        std::thread lexThread([&] {
+            TokenBatch batch;
+            bool done = false;
+
+            while (!done && !stop.load(std::memory_order_relaxed)) {
+                lexer.nextTokens(batch);
+                for (size_t i = 0; i < batch.count && !done; ++i) {
+                    LexItem item{batch.type[i], batch.offset[i], batch.length[i]};
+                    // 语法分析提前结束时队列被关闭，push 返回 false
+                    if (!queue.push(item)) {
+                        done = true;
+                        break;
+                    }
+                    done = (item.type == TokenType::ENDFILE ||
+                            item.type == TokenType::ERROR);
+                }
+            }
+            queue.close();
+        });
+
+        // 出队一个 token 并转为文法符号；ENDFILE 即输入结束
+        bool lexicalError = false;
+        auto nextToken = [&](GrammarSymbol& sym) {
+            LexItem item;
+            if (!queue.pop(item) || item.type == TokenType::ENDFILE) {
+                return false;
+            }
+
+            std::string_view lexeme = text.substr(item.offset, item.length);
+            if (item.type == TokenType::ERROR) {
+                LineCol lc = parser.Lines.resolve(item.offset);
+                lexicalError = true;
+                throw std::runtime_error(
+                    "Lexical Error: illegal character '" + std::string(lexeme) +
+                    "'\nat line " + std::to_string(lc.line) +
+                    ", column " + std::to_string(lc.column));
+            }
+
+            // 种类绑定不上终结符时（多条字面量规则共用一个种类、正则种类等）
+            // 与 token 文件的读入方式一致，再按 token 文本查终结符
+            int terminal = terminalOf[(size_t)item.type];
+            if (terminal == -1) {
+                terminal = slrTable.TerminalIdOf(std::string(lexeme));
+            }
+            sym = GrammarSymbol(std::string(lexeme), true,
+                                kinds.name(item.type),
+                                SourceLoc{item.offset, 0},
+                                terminal);
+            return true;
+        };
+
+        bool success = false;
+        std::string error;
+        try {
+            success = parser.Parse(nextToken);
+        }
+        catch (const std::exception& e) {
+            error = e.what();
+        }
+
+        // 无论语法分析如何结束，都让词法线程退出
+        stop.store(true, std::memory_order_relaxed);
+        queue.close();
+        lexThread.join();
+
+        // 结果行与 SyntacticAnalyzer.exe 相同；语法分析器的输出是 GBK 编码，
+        // 这里写成字节转义以保持一致
+        // （"移进-归约分析测试错误: " / "移进-归约分析成功！" / "移进-归约分析失败！"）
+        if (lexicalError) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        if (!error.empty()) {
+            std::cout << "\xd2\xc6\xbd\xf8-\xb9\xe9\xd4\xbc\xb7\xd6\xce\xf6"
+                         "\xb2\xe2\xca\xd4\xb4\xed\xce\xf3: " << error << std::endl;
+            std::cerr << "[Compiler] Parser failed.\n";
+            return 1;
+        }
+        if (!success) {
+            std::cout << "\n\xd2\xc6\xbd\xf8-\xb9\xe9\xd4\xbc\xb7\xd6\xce\xf6"
+                         "\xca\xa7\xb0\xdc\xa3\xa1" << std::endl;
+            std::cerr << "[Compiler] Parser failed.\n";
+            return 1;
+        }
+
+        std::cout << "\n\xd2\xc6\xbd\xf8-\xb9\xe9\xd4\xbc\xb7\xd6\xce\xf6"
+                     "\xb3\xc9\xb9\xa6\xa3\xa1" << std::endl;
+#ifdef SEM_IR
+        parser.DumpIR();
+#endif
+    }
+    catch (const std::exception& e) {
+        std::cerr << "[Compiler] Fatal Error: " << e.what() << "\n";
         return 1;
     }
 
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+/*
+ * SpscQueue
+ * =========
+ * 有界、无锁的单生产者 / 单消费者环形队列
+ *
+ * - 容量取 2 的幂，下标用位与取模
+ * - head 只由消费者写、tail 只由生产者写，各占一条缓存行，避免伪共享
+ * - 生产者以 release 发布 tail，消费者以 acquire 读取（head 反之）
+ * - 队列满 / 空时自旋后让出 CPU；另一端通过 close() 结束等待
+ */
+template <class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        slots.resize(cap);
+        mask = cap - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // 生产者：放入一个元素；队列已关闭时返回 false
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+
+        while (t - headCache == slots.size()) {
+            headCache = head.load(std::memory_order_acquire);
+            if (t - headCache < slots.size()) break;
+            if (closed.load(std::memory_order_relaxed)) return false;
+            std::this_thread::yield();
+        }
+
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者：取出一个元素；队列已关闭且已取空时返回 false
+    bool pop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+
+        while (h == tailCache) {
+            tailCache = tail.load(std::memory_order_acquire);
+            if (h != tailCache) break;
+            if (closed.load(std::memory_order_acquire)) {
+                // 关闭前的最后几次 push 可能刚刚发布
+                tailCache = tail.load(std::memory_order_acquire);
+                if (h != tailCache) break;
+                return false;
+            }
+            std::this_thread::yield();
+        }
+
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 任一端调用：不再生产 / 不再消费
+    void close() { closed.store(true, std::memory_order_release); }
+
+private:
+    static constexpr size_t CACHE_LINE = 64;
+
+    std::vector<T> slots;
+    size_t mask = 0;
+
+    alignas(CACHE_LINE) std::atomic<size_t> head{0};  // 消费者写
+    size_t tailCache = 0;                             // 消费者看到的 tail
+
+    alignas(CACHE_LINE) std::atomic<size_t> tail{0};  // 生产者写
+    size_t headCache = 0;                             // 生产者看到的 head
+
+    alignas(CACHE_LINE) std::atomic<bool> closed{false};
+};
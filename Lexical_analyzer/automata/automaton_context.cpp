@@ -0,0 +1,16 @@
+#include "automaton_context.h"
+
+RegexNode* AutomatonContext::newRegex(RegexType type, char ch,
+                                      RegexNode* left, RegexNode* right) {
+    return regexNodes.make(type, ch, left, right);
+}
+
+State* AutomatonContext::newState() {
+    State* s = states.make();
+    s->id = nextStateId++;
+    return s;
+}
+
+DFAState* AutomatonContext::newDFAState() {
+    return dfaStates.make();
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+#include "regex_ast.h"
+#include "nfa.h"
+#include "dfa.h"
+
+/*
+ * ObjectArena
+ * ===========
+ * 同类对象的分块竞技场：按块申请内存，逐个原位构造，析构时整体释放
+ *
+ * - 对象地址在竞技场生命周期内保持不变（只追加新块，不搬移旧块）
+ * - 不支持单个释放；自动机结点之间互相指向，本来就只能一起释放
+ */
+template <class T>
+class ObjectArena {
+public:
+    explicit ObjectArena(size_t blockSize = 256) : blockSize(blockSize) {}
+
+    ~ObjectArena() {
+        // 逆序析构：后构造的先析构
+        for (size_t b = blocks.size(); b-- > 0;) {
+            T* block = blocks[b];
+            size_t n = (b + 1 == blocks.size()) ? used : blockSize;
+            for (size_t i = n; i-- > 0;) {
+                block[i].~T();
+            }
+            ::operator delete(block);
+        }
+    }
+
+    ObjectArena(const ObjectArena&) = delete;
+    ObjectArena& operator=(const ObjectArena&) = delete;
+
+    template <class... Args>
+    T* make(Args&&... args) {
+        if (blocks.empty() || used == blockSize) {
+            blocks.push_back(static_cast<T*>(::operator new(blockSize * sizeof(T))));
+            used = 0;
+        }
+        T* p = new (blocks.back() + used) T(std::forward<Args>(args)...);
+        used++;
+        return p;
+    }
+
+    // 已构造的对象数
+    size_t size() const {
+        return blocks.empty() ? 0 : (blocks.size() - 1) * blockSize + used;
+    }
+
+private:
+    size_t blockSize;
+    size_t used = 0;          // 最后一块中已使用的槽数
+    std::vector<T*> blocks;
+};
+
+/*
+ * AutomatonContext
+ * ================
+ * 一次词法分析器构造过程的结点所有者
+ *
+ * - 正则 AST、NFA 状态、DFA 状态都从这里分配，随上下文析构一并释放
+ * - 状态编号按上下文各自递增，不再有全局计数器，
+ *   同一进程内可以先后（或在不同线程里同时）构造多个词法分析器
+ * - 上下文不可复制 / 移动：结点之间、DFA 与结点之间都以裸指针相连，
+ *   因此由它构造出的 NFA / DFA 不能比它活得久
+ */
+class AutomatonContext {
+public:
+    AutomatonContext() = default;
+    AutomatonContext(const AutomatonContext&) = delete;
+    AutomatonContext& operator=(const AutomatonContext&) = delete;
+
+    // 正则 AST 结点
+    RegexNode* newRegex(RegexType type,
+                        char ch = 0,
+                        RegexNode* left = nullptr,
+                        RegexNode* right = nullptr);
+
+    // NFA 状态（id 自动递增，便于调试）
+    State* newState();
+
+    // DFA 状态（id 由构造算法按其在 DFA::states 中的位置填写）
+    DFAState* newDFAState();
+
+    // 各类结点的数量（调试 / 统计用）
+    size_t regexCount() const { return regexNodes.size(); }
+    size_t stateCount() const { return states.size(); }
+    size_t dfaStateCount() const { return dfaStates.size(); }
+
+private:
+    ObjectArena<RegexNode> regexNodes;
+    ObjectArena<State> states;
+    ObjectArena<DFAState> dfaStates;
+
+    int nextStateId = 0;
+};
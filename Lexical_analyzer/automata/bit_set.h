@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * BitSet
+ * ======
+ * 构造自动机时使用的定长位图（状态 / 位置集合）
+ * 同一次构造中的位图字数相同，并、判重都是整字操作
+ */
+using BitSet = std::vector<uint64_t>;
+
+// n 位的空集合
+inline BitSet makeBitSet(size_t n) {
+    return BitSet((n + 63) / 64, 0);
+}
+
+inline void setBit(BitSet& bits, int i) {
+    bits[(size_t)i / 64] |= 1ULL << (i % 64);
+}
+
+inline bool testBit(const BitSet& bits, int i) {
+    return (bits[(size_t)i / 64] >> (i % 64)) & 1;
+}
+
+// dst ∪= src
+inline void orInto(BitSet& dst, const BitSet& src) {
+    for (size_t i = 0; i < dst.size(); ++i) dst[i] |= src[i];
+}
+
+// 依次回调 bits 中置位的下标（升序）
+template <class F>
+void forEachBit(const BitSet& bits, F&& f) {
+    for (size_t w = 0; w < bits.size(); ++w) {
+        for (uint64_t word = bits[w]; word; word &= word - 1) {
+            f((int)(w * 64 + __builtin_ctzll(word)));
+        }
+    }
+}
+
+// 散列：FNV-1a，按 64 位字混合
+struct BitSetHash {
+    size_t operator()(const BitSet& b) const {
+        uint64_t h = 1469598103934665603ULL;
+        for (uint64_t w : b) {
+            h ^= w;
+            h *= 1099511628211ULL;
+        }
+        return (size_t)(h ^ (h >> 32));
+    }
+};
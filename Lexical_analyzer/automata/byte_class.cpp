@@ -0,0 +1,123 @@
+#include "byte_class.h"
+#include <algorithm>
+#include <map>
+#include <set>
+#include <utility>
+
+/*
+ * 收集所有可达 NFA 状态
+ */
+static std::vector<State*> reachableStates(State* start) {
+    std::vector<State*> order;
+    std::set<State*> visited;
+    std::vector<State*> stack{start};
+
+    while (!stack.empty()) {
+        State* s = stack.back();
+        stack.pop_back();
+        if (!s || !visited.insert(s).second) continue;
+        order.push_back(s);
+
+        for (auto& [_, targets] : s->trans)
+            for (auto* t : targets) stack.push_back(t);
+        for (auto& [_, t] : s->sets) stack.push_back(t);
+        for (auto* t : s->eps) stack.push_back(t);
+    }
+    return order;
+}
+
+/*
+ * 用一个局部划分细化当前划分：
+ * (旧类, 局部编号) -> 新类，按字节顺序编号保证确定性
+ */
+static void refine(std::array<int, 256>& cls, const std::array<int, 256>& local) {
+    std::map<std::pair<int, int>, int> refined;
+    for (int b = 0; b < 256; ++b) {
+        auto it = refined.emplace(std::make_pair(cls[b], local[b]),
+                                  (int)refined.size()).first;
+        cls[b] = it->second;
+    }
+}
+
+/*
+ * 划分 -> ByteClasses（类编号已按字节顺序首次出现排列）
+ */
+static ByteClasses toByteClasses(const std::array<int, 256>& cls) {
+    ByteClasses classes;
+    classes.count = 0;
+    for (int b = 0; b < 256; ++b) {
+        classes.classOf[b] = (unsigned char)cls[b];
+        if (cls[b] == classes.count) {
+            classes.representative.push_back((unsigned char)b);
+            classes.count++;
+        }
+    }
+    return classes;
+}
+
+ByteClasses computeByteClasses(State* nfaStart) {
+    // 初始：所有字节同属类 0
+    std::array<int, 256> cls{};
+
+    for (auto* s : reachableStates(nfaStart)) {
+        if (s->trans.empty() && s->sets.empty()) continue;
+
+        // 本状态上每个字节的目标集合（字符边与字符类边合并）
+        std::array<std::vector<State*>, 256> targetsOf;
+        for (auto& [ch, targets] : s->trans) {
+            auto& key = targetsOf[(unsigned char)ch];
+            key.insert(key.end(), targets.begin(), targets.end());
+        }
+        for (auto& [set, t] : s->sets) {
+            for (int b = 0; b < 256; ++b) {
+                if (set.contains((unsigned char)b)) targetsOf[b].push_back(t);
+            }
+        }
+
+        // 局部划分：无转移为 0，同一目标集合同一编号
+        std::map<std::vector<State*>, int> targetIds;
+        std::array<int, 256> local{};
+        for (int b = 0; b < 256; ++b) {
+            auto& key = targetsOf[b];
+            if (key.empty()) continue;
+            std::sort(key.begin(), key.end());
+            key.erase(std::unique(key.begin(), key.end()), key.end());
+            auto it = targetIds.emplace(key, (int)targetIds.size() + 1).first;
+            local[b] = it->second;
+        }
+
+        refine(cls, local);
+    }
+
+    return toByteClasses(cls);
+}
+
+ByteClasses computeByteClasses(const std::vector<RegexNode*>& roots) {
+    std::array<int, 256> cls{};
+
+    // AST 可能共享子树（如 NUM 中的 digit），每个结点只需细化一次
+    std::set<const RegexNode*> visited;
+    std::vector<const RegexNode*> stack(roots.begin(), roots.end());
+
+    while (!stack.empty()) {
+        const RegexNode* node = stack.back();
+        stack.pop_back();
+        if (!node || !visited.insert(node).second) continue;
+
+        if (node->type == RegexType::CHAR) {
+            std::array<int, 256> local{};
+            local[(unsigned char)node->ch] = 1;
+            refine(cls, local);
+        } else if (node->type == RegexType::CHARSET) {
+            std::array<int, 256> local{};
+            for (int b = 0; b < 256; ++b) {
+                local[b] = node->set.contains((unsigned char)b);
+            }
+            refine(cls, local);
+        }
+        stack.push_back(node->left);
+        stack.push_back(node->right);
+    }
+
+    return toByteClasses(cls);
+}
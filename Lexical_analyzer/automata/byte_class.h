@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "nfa.h"
+#include "regex_ast.h"
+
+/*
+ * ByteClasses
+ * ===========
+ * 字节等价类：在所有规则中行为完全相同的字节归为一类
+ *
+ * 例如 {ID} 尾部的 63 个字符在每个 NFA 状态上
+ * 都走向同一组目标，因此只需一个类编号
+ *
+ * DFA 的边、转移表的列都以类编号为下标
+ */
+struct ByteClasses {
+    int count = 1;                          // 类的数量
+    std::array<unsigned char, 256> classOf{};   // 字节 -> 类编号
+    std::vector<unsigned char> representative; // 类编号 -> 代表字节
+
+    int of(unsigned char c) const { return classOf[c]; }
+};
+
+/*
+ * computeByteClasses
+ * ==================
+ * 遍历从 nfaStart 可达的所有 NFA 状态，
+ * 按各状态的字符转移对 0..255 做划分细化
+ */
+ByteClasses computeByteClasses(State* nfaStart);
+
+/*
+ * computeByteClasses（正则 AST 版）
+ * ================================
+ * 不经过 NFA：按每个字符 / 字符类叶结点的字节集合做划分细化
+ * Thompson 构造中每个叶结点恰好对应一条字符（类）转移，
+ * 因此结果与由同一组 AST 构造的 NFA 上的划分完全相同
+ */
+ByteClasses computeByteClasses(const std::vector<RegexNode*>& roots);
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+
 /*
  * 字符分类工具
  * ============
@@ -39,3 +41,61 @@ constexpr bool isBlank(unsigned char c) noexcept {
 constexpr bool isNewline(unsigned char c) noexcept {
     return c == '\n';
 }
+
+/*
+ * ByteRanges
+ * ==========
+ * 由至多 MAX 个闭区间 [lo, hi] 组成的字节集合
+ * 例如标识符尾部：[0-9] [A-Z] _ [a-z] 共 4 段
+ *
+ * 区间形式便于向量化：每段只需一次减法和一次饱和比较
+ */
+struct ByteRanges {
+    static constexpr int MAX = 4;
+
+    int count = 0;               // 区间个数，0 表示空集
+    unsigned char lo[MAX] = {};
+    unsigned char hi[MAX] = {};
+
+    constexpr bool contains(unsigned char c) const noexcept {
+        for (int k = 0; k < count; ++k) {
+            if (c >= lo[k] && c <= hi[k]) return true;
+        }
+        return false;
+    }
+};
+
+/*
+ * ByteSet
+ * =======
+ * 任意字节集合（256 位），正则中的字符类 [a-z_] / [^\n] / \d 等
+ *
+ * NFA 上一条字符类边即一个 ByteSet，不再展开成逐字符的 UNION 链
+ */
+struct ByteSet {
+    uint64_t words[4] = {};
+
+    constexpr void add(unsigned char c) noexcept {
+        words[c >> 6] |= uint64_t(1) << (c & 63);
+    }
+
+    constexpr void addRange(unsigned char lo, unsigned char hi) noexcept {
+        for (int c = lo; c <= hi; ++c) add((unsigned char)c);
+    }
+
+    constexpr void addSet(const ByteSet& other) noexcept {
+        for (int w = 0; w < 4; ++w) words[w] |= other.words[w];
+    }
+
+    constexpr void invert() noexcept {
+        for (int w = 0; w < 4; ++w) words[w] = ~words[w];
+    }
+
+    constexpr bool contains(unsigned char c) const noexcept {
+        return (words[c >> 6] >> (c & 63)) & 1;
+    }
+
+    constexpr bool empty() const noexcept {
+        return (words[0] | words[1] | words[2] | words[3]) == 0;
+    }
+};
@@ -1,50 +1,111 @@
 #include "dfa.h"
-#include <queue>
-#include <map>
+#include "automaton_context.h"
+#include "bit_set.h"
 #include <algorithm>
+#include <cstdint>
+#include <unordered_map>
 
 /*
- * ε-closure
- * =========
- * 计算一组 NFA 状态的 ε 闭包
+ * 子集构造的内部表示
+ * ==================
+ * - NFA 状态按 id 排序后编为稠密下标 0..n-1
+ * - NFA 状态集合用定长位图（n 位）表示，并 / 判重都是整字操作
+ * - 每个 NFA 状态的 ε-closure 首次用到时算一次，之后直接按位或
+ * - 已有的 DFA 状态按位图散列判重
  */
-static std::set<State*> epsilonClosure(const std::set<State*>& states) {
-    std::set<State*> closure = states;
-    std::queue<State*> q;
+namespace {
 
-    for (auto* s : states)
-        q.push(s);
-
-    while (!q.empty()) {
-        State* s = q.front();
-        q.pop();
+/*
+ * DenseNFA
+ * ========
+ * 从起始状态可达的 NFA，换成下标表示
+ */
+struct DenseNFA {
+    int n = 0;                                  // 状态数
+    int start = 0;                              // 起始状态下标
+    std::vector<std::vector<int>> eps;          // ε 转移目标
+    std::vector<std::vector<std::pair<int, int>>> moves; // (字节类, 目标)
+    std::vector<TokenType> acceptToken;
+
+    std::vector<BitSet> closure;                // ε-closure 缓存
+    std::vector<unsigned char> closureReady;
+
+    DenseNFA(State* start_, const ByteClasses& classes) {
+        // 收集可达状态
+        std::vector<State*> order;
+        std::unordered_map<const State*, int> index;
+        std::vector<State*> stack{start_};
+        while (!stack.empty()) {
+            State* s = stack.back();
+            stack.pop_back();
+            if (!s || !index.emplace(s, 0).second) continue;
+            order.push_back(s);
+            for (auto& [_, targets] : s->trans)
+                for (auto* t : targets) stack.push_back(t);
+            for (auto& [_, t] : s->sets) stack.push_back(t);
+            for (auto* t : s->eps) stack.push_back(t);
+        }
 
-        for (auto* t : s->eps) {
-            if (!closure.count(t)) {
-                closure.insert(t);
-                q.push(t);
+        // 按创建顺序编号：同优先级的接受 token 取先创建者，结果与遍历顺序无关
+        std::sort(order.begin(), order.end(),
+                  [](const State* a, const State* b) { return a->id < b->id; });
+        n = (int)order.size();
+        for (int i = 0; i < n; ++i) index[order[i]] = i;
+        start = index.at(start_);
+
+        eps.resize(n);
+        moves.resize(n);
+        acceptToken.resize(n);
+        for (int i = 0; i < n; ++i) {
+            const State* s = order[i];
+            acceptToken[i] = s->acceptToken;
+            for (auto* t : s->eps) eps[i].push_back(index.at(t));
+            for (auto& [ch, targets] : s->trans) {
+                int cls = classes.of((unsigned char)ch);
+                for (auto* t : targets) moves[i].push_back({cls, index.at(t)});
+            }
+            // 字符类边：等价类不会跨越集合边界，按类各展开一次
+            for (auto& [set, t] : s->sets) {
+                std::vector<unsigned char> seen(classes.count, 0);
+                for (int b = 0; b < 256; ++b) {
+                    int cls = classes.of((unsigned char)b);
+                    if (set.contains((unsigned char)b) && !seen[cls]) {
+                        seen[cls] = 1;
+                        moves[i].push_back({cls, index.at(t)});
+                    }
+                }
             }
         }
+
+        closure.resize(n);
+        closureReady.assign(n, 0);
     }
-    return closure;
-}
 
-/*
- * move
- * ====
- * 从一组 NFA 状态，经字符 ch 能到达的状态集合
- */
-static std::set<State*> moveSet(const std::set<State*>& states, char ch) {
-    std::set<State*> result;
-    for (auto* s : states) {
-        auto it = s->trans.find(ch);
-        if (it != s->trans.end()) {
-            for (auto* t : it->second)
-                result.insert(t);
+    BitSet empty() const { return makeBitSet((size_t)n); }
+
+    // 单个状态的 ε-closure（缓存）
+    const BitSet& closureOf(int s) {
+        if (closureReady[s]) return closure[s];
+
+        BitSet bits = empty();
+        std::vector<int> stack{s};
+        setBit(bits, s);
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+            for (int v : eps[u]) {
+                if (!testBit(bits, v)) {
+                    setBit(bits, v);
+                    stack.push_back(v);
+                }
+            }
         }
+
+        closure[s] = std::move(bits);
+        closureReady[s] = 1;
+        return closure[s];
     }
-    return result;
-}
+};
 
 /*
  * 从 NFA 状态集合中选取 Token
@@ -52,20 +113,20 @@ static std::set<State*> moveSet(const std::set<State*>& states, char ch) {
  * 规则：
  * 1. 若集合中存在接受态
  * 2. 选 TokenType != ERROR
- * 3. 若多个，按枚举顺序（关键字优先）
+ * 3. 若多个，按 tokenPriority（关键字优先），同优先级取先创建的状态
  */
-static void chooseAcceptToken(DFAState* dfaState) {
+void chooseAcceptToken(const DenseNFA& nfa, const BitSet& set, DFAState* dfaState) {
     TokenType best = TokenType::ERROR;
 
-    for (auto* s : dfaState->nfaStates) {
-        if (s->acceptToken != TokenType::ERROR) {
+    forEachBit(set, [&](int s) {
+        TokenType t = nfa.acceptToken[s];
+        if (t != TokenType::ERROR) {
             if (best == TokenType::ERROR ||
-                tokenPriority(s->acceptToken) <
-                tokenPriority(best)) {
-                best = s->acceptToken;
+                tokenPriority(t) < tokenPriority(best)) {
+                best = t;
             }
         }
-    }
+    });
 
     if (best != TokenType::ERROR) {
         dfaState->isAccept = true;
@@ -73,69 +134,61 @@ static void chooseAcceptToken(DFAState* dfaState) {
     }
 }
 
+} // namespace
+
 /*
  * buildDFA
  * ========
  * 子集构造主算法
  */
-DFA buildDFA(State* nfaStart) {
+DFA buildDFA(AutomatonContext& ctx, State* nfaStart, const ByteClasses& classes) {
     DFA dfa;
-    int dfaId = 0;
-
-    // 起始 ε-closure
-    std::set<State*> startSet;
-    startSet.insert(nfaStart);
-    startSet = epsilonClosure(startSet);
-
-    auto* startDFA = new DFAState();
-    startDFA->id = dfaId++;
-    startDFA->nfaStates = startSet;
-    chooseAcceptToken(startDFA);
-
-    dfa.start = startDFA;
-    dfa.states.push_back(startDFA);
-
-    // 用 map 判重：NFA 状态集合 -> DFAState*
-    std::map<std::set<State*>, DFAState*> dfaMap;
-    dfaMap[startSet] = startDFA;
-
-    std::queue<DFAState*> worklist;
-    worklist.push(startDFA);
-
-    while (!worklist.empty()) {
-        DFAState* cur = worklist.front();
-        worklist.pop();
-
-        // 收集所有可能的输入字符
-        std::set<char> alphabet;
-        for (auto* s : cur->nfaStates) {
-            for (auto& [ch, _] : s->trans)
-                alphabet.insert(ch);
+    dfa.classes = classes;
+
+    DenseNFA nfa(nfaStart, classes);
+
+    // 位图 -> DFA 状态下标；sets[i] 指向 dfa.states[i] 对应的 NFA 状态集合
+    // （即表中的键，结点地址在插入后保持不变）
+    std::unordered_map<BitSet, int, BitSetHash> dfaMap;
+    std::vector<const BitSet*> sets;
+
+    auto addState = [&](BitSet&& set) {
+        auto [it, inserted] = dfaMap.emplace(std::move(set), (int)sets.size());
+        if (inserted) {
+            DFAState* s = ctx.newDFAState();
+            s->id = (int)dfa.states.size();
+            chooseAcceptToken(nfa, it->first, s);
+            dfa.states.push_back(s);
+            sets.push_back(&it->first);
         }
+        return it->second;
+    };
 
-        // 对每个字符做 move + ε-closure
-        for (char ch : alphabet) {
-            std::set<State*> moved = moveSet(cur->nfaStates, ch);
-            if (moved.empty()) continue;
-
-            std::set<State*> nextSet = epsilonClosure(moved);
-
-            DFAState* nextDFA = nullptr;
-            auto it = dfaMap.find(nextSet);
-            if (it != dfaMap.end()) {
-                nextDFA = it->second;
-            } else {
-                nextDFA = new DFAState();
-                nextDFA->id = dfaId++;
-                nextDFA->nfaStates = nextSet;
-                chooseAcceptToken(nextDFA);
-
-                dfa.states.push_back(nextDFA);
-                dfaMap[nextSet] = nextDFA;
-                worklist.push(nextDFA);
+    // 起始 ε-closure
+    dfa.start = dfa.states[addState(BitSet(nfa.closureOf(nfa.start)))];
+
+    // 按字节类累积的目标集合，只清理本轮碰到的类
+    std::vector<BitSet> next(classes.count, nfa.empty());
+    std::vector<unsigned char> touched(classes.count, 0);
+
+    // 新状态按编号顺序处理，等价于 FIFO 工作表
+    for (size_t cur = 0; cur < sets.size(); ++cur) {
+        // move + ε-closure：对集合中每个状态的每条边，并入目标的闭包
+        forEachBit(*sets[cur], [&](int s) {
+            for (auto& [cls, to] : nfa.moves[s]) {
+                orInto(next[cls], nfa.closureOf(to));
+                touched[cls] = 1;
             }
+        });
+
+        // 按字节类升序建立转移
+        for (int cls = 0; cls < classes.count; ++cls) {
+            if (!touched[cls]) continue;
+            touched[cls] = 0;
 
-            cur->trans[ch] = nextDFA;
+            int to = addState(std::move(next[cls]));
+            next[cls] = nfa.empty();
+            dfa.states[cur]->trans[cls] = dfa.states[to];
         }
     }
 
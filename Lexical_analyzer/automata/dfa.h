@@ -5,27 +5,26 @@
 #include <vector>
 #include "token.h"
 #include "nfa.h"
+#include "byte_class.h"
+#include "keyword_table.h"
 
 /*
  * DFAState
  * ========
  * DFA 中的一个状态
- * 本质：一组 NFA 状态的 ε-closure
+ * 本质：一组 NFA 状态的 ε-closure（集合本身只在构造期间以位图保存）
  */
 struct DFAState {
-    int id;   // DFA 状态编号（调试用）
+    int id = 0;   // DFA 状态编号（调试用）
 
-    // DFA 转移：字符 -> 唯一目标状态
-    std::map<char, DFAState*> trans;
+    // DFA 转移：字节等价类编号 -> 唯一目标状态
+    std::map<int, DFAState*> trans;
 
     // 是否为接受态
     bool isAccept = false;
 
     // 接受态对应的 Token
     TokenType acceptToken = TokenType::ERROR;
-
-    // 该 DFA 状态对应的 NFA 状态集合
-    std::set<State*> nfaStates;
 };
 
 /*
@@ -35,13 +34,18 @@ struct DFAState {
  */
 struct DFA {
     DFAState* start;                 // 起始状态
-    std::vector<DFAState*> states;   // 所有 DFA 状态（便于遍历 / 释放）
+    std::vector<DFAState*> states;   // 所有 DFA 状态（便于遍历；由上下文释放）
+    ByteClasses classes;             // 字节 -> 等价类（边的字母表）
+    KeywordTable keywords;           // 移出自动机的关键字（空表示未启用）
+    TokenKinds kinds;                // 规则集定义的 Token 种类
 };
 
 /*
  * buildDFA
  * ========
  * 子集构造法：
- * 从 NFA 起始状态构造 DFA
+ * 从 NFA 起始状态构造 DFA，字母表为字节等价类
+ * DFA 状态分配在 ctx 中，DFA 不能比 ctx 活得久
  */
-DFA buildDFA(State* nfaStart);
+class AutomatonContext;
+DFA buildDFA(AutomatonContext& ctx, State* nfaStart, const ByteClasses& classes);
@@ -1,115 +1,256 @@
 #include "dfa_min.h"
+#include "automaton_context.h"
 #include <map>
-#include <set>
+#include <unordered_map>
 #include <vector>
 
 /*
- * 初始划分：
- *  - 非接受态
- *  - 接受态（按 TokenType 再细分）
+ * Hopcroft 划分细化
+ * =================
+ * 状态用整数下标表示，时间 O(k · n log n)（k 为字节类数）
+ *
+ * - DFA 是部分的（缺省转移即死状态），补一个汇点 n 使其完全：
+ *   缺省转移都指向汇点，汇点在每个类上指向自身
+ * - 初始划分：非接受态（含汇点）+ 接受态按 TokenType 再细分
+ * - 以块为分割者：取出一个块，对每个字节类求其前驱集合，
+ *   把被部分覆盖的块一分为二；被分割的块已在工作表中时新块也入表，
+ *   否则只让较小的一半入表
+ * - 汇点所在块即死状态，构造新 DFA 时丢弃
+ * - 新状态按从起始状态出发、字节类升序的 BFS 顺序编号：
+ *   最小 DFA 在同构意义下唯一，因此无论输入 DFA 由哪条路径构造，
+ *   只要语言与等价类相同，结果就逐项相同
  */
-static std::vector<std::set<DFAState*>> initialPartition(const DFA& dfa) {
-    std::map<TokenType, std::set<DFAState*>> acceptGroups;
-    std::set<DFAState*> nonAccept;
+namespace {
 
-    for (auto* s : dfa.states) {
-        if (!s->isAccept) {
-            nonAccept.insert(s);
-        } else {
-            acceptGroups[s->acceptToken].insert(s);
+/*
+ * Partition
+ * =========
+ * 可细化划分：elems 中每个块占一段连续区间，
+ * 标记的元素被换到区间前部，分割时前部成为新块
+ */
+struct Partition {
+    std::vector<int> elems;     // 按块排列的元素
+    std::vector<int> loc;       // 元素 -> 在 elems 中的位置
+    std::vector<int> blockOf;   // 元素 -> 块编号
+    std::vector<int> first;     // 块 -> 区间起点
+    std::vector<int> end;       // 块 -> 区间终点（不含）
+    std::vector<int> marked;    // 块 -> 已标记元素数
+
+    explicit Partition(int n) : elems(n), loc(n), blockOf(n, 0) {
+        for (int i = 0; i < n; ++i) elems[i] = loc[i] = i;
+    }
+
+    int size(int b) const { return end[b] - first[b]; }
+
+    // 按给定分组建立初始划分（每组元素非空）
+    void init(const std::vector<std::vector<int>>& groups) {
+        int pos = 0;
+        for (const auto& g : groups) {
+            int b = (int)first.size();
+            first.push_back(pos);
+            for (int s : g) {
+                elems[pos] = s;
+                loc[s] = pos++;
+                blockOf[s] = b;
+            }
+            end.push_back(pos);
+            marked.push_back(0);
         }
     }
 
-    std::vector<std::set<DFAState*>> P;
-    if (!nonAccept.empty()) {
-        P.push_back(nonAccept);
+    void mark(int s) {
+        int b = blockOf[s];
+        int target = first[b] + marked[b];
+        if (loc[s] < target) return;   // 已标记
+
+        int other = elems[target];
+        elems[loc[s]] = other;
+        loc[other] = loc[s];
+        elems[target] = s;
+        loc[s] = target;
+        marked[b]++;
     }
-    for (auto& [_, group] : acceptGroups) {
-        P.push_back(group);
+
+    // 把块 b 中已标记的部分分出去；返回新块编号，无需分割时返回 -1
+    int split(int b) {
+        int m = marked[b];
+        marked[b] = 0;
+        if (m == 0 || m == size(b)) return -1;
+
+        int nb = (int)first.size();
+        first.push_back(first[b]);
+        end.push_back(first[b] + m);
+        marked.push_back(0);
+        first[b] += m;
+
+        for (int i = first[nb]; i < end[nb]; ++i) {
+            blockOf[elems[i]] = nb;
+        }
+        return nb;
     }
-    return P;
-}
+};
 
-/*
- * 查找状态属于哪个分组
- */
-static int findBlock(
-    const std::vector<std::set<DFAState*>>& P,
-    DFAState* s
-) {
-    for (int i = 0; i < (int)P.size(); ++i) {
-        if (P[i].count(s)) return i;
-    }
-    return -1;
-}
+} // namespace
 
-DFA minimizeDFA(const DFA& dfa) {
-    auto P = initialPartition(dfa);
-    bool changed = true;
+DFA minimizeDFA(AutomatonContext& ctx, const DFA& dfa) {
+    const int n = (int)dfa.states.size();
+    const int sink = n;
+    const int total = n + 1;
+    const int k = dfa.classes.count;
 
-    while (changed) {
-        changed = false;
-        std::vector<std::set<DFAState*>> newP;
+    std::unordered_map<const DFAState*, int> index;
+    for (int i = 0; i < n; ++i) {
+        index[dfa.states[i]] = i;
+    }
 
-        for (auto& block : P) {
-            std::map<
-                std::map<char, int>,
-                std::set<DFAState*>
-            > splitter;
+    // ===== 完全转移表与逆转移（按类的 CSR）=====
+    std::vector<int> delta((size_t)total * k, sink);
+    for (int i = 0; i < n; ++i) {
+        for (auto& [cls, to] : dfa.states[i]->trans) {
+            delta[(size_t)i * k + cls] = index.at(to);
+        }
+    }
 
-            for (auto* s : block) {
-                std::map<char, int> signature;
+    // invStart[c * (total + 1) + t] .. 下一项：类 c 上转移到 t 的源状态
+    std::vector<int> invStart((size_t)k * (total + 1) + 1, 0);
+    std::vector<int> invSrc((size_t)total * k);
+    for (int s = 0; s < total; ++s) {
+        for (int c = 0; c < k; ++c) {
+            invStart[(size_t)c * (total + 1) + delta[(size_t)s * k + c] + 1]++;
+        }
+    }
+    for (size_t i = 1; i < invStart.size(); ++i) {
+        invStart[i] += invStart[i - 1];
+    }
+    {
+        std::vector<int> fill(invStart.begin(), invStart.end() - 1);
+        for (int s = 0; s < total; ++s) {
+            for (int c = 0; c < k; ++c) {
+                invSrc[fill[(size_t)c * (total + 1) + delta[(size_t)s * k + c]]++] = s;
+            }
+        }
+    }
 
-                for (auto& [ch, to] : s->trans) {
-                    signature[ch] = findBlock(P, to);
-                }
+    // ===== 初始划分 =====
+    std::vector<std::vector<int>> groups(1);
+    std::map<TokenType, int> acceptGroup;
+    for (int i = 0; i < n; ++i) {
+        const DFAState* s = dfa.states[i];
+        if (!s->isAccept) {
+            groups[0].push_back(i);
+        } else {
+            auto [it, inserted] = acceptGroup.emplace(s->acceptToken,
+                                                      (int)groups.size());
+            if (inserted) groups.emplace_back();
+            groups[it->second].push_back(i);
+        }
+    }
+    groups[0].push_back(sink);
+
+    Partition P(total);
+    P.init(groups);
+
+    // ===== 细化 =====
+    std::vector<int> worklist;
+    std::vector<unsigned char> inWork(total, 0);
+    for (int b = 0; b < (int)groups.size(); ++b) {
+        worklist.push_back(b);
+        inWork[b] = 1;
+    }
+
+    std::vector<int> splitter;
+    std::vector<int> touched;
+    while (!worklist.empty()) {
+        int a = worklist.back();
+        worklist.pop_back();
+        inWork[a] = 0;
 
-                splitter[signature].insert(s);
+        // 取出时的成员快照：处理各类时 a 自身也可能被分割
+        splitter.assign(P.elems.begin() + P.first[a], P.elems.begin() + P.end[a]);
+
+        for (int c = 0; c < k; ++c) {
+            const int* base = invSrc.data();
+            for (int t : splitter) {
+                size_t row = (size_t)c * (total + 1) + t;
+                for (int i = invStart[row]; i < invStart[row + 1]; ++i) {
+                    int p = base[i];
+                    int b = P.blockOf[p];
+                    if (P.marked[b] == 0) touched.push_back(b);
+                    P.mark(p);
+                }
             }
 
-            if (splitter.size() == 1) {
-                newP.push_back(block);
-            } else {
-                changed = true;
-                for (auto& [_, part] : splitter) {
-                    newP.push_back(part);
+            for (int b : touched) {
+                int nb = P.split(b);
+                if (nb < 0) continue;
+
+                if (inWork[b]) {
+                    worklist.push_back(nb);
+                    inWork[nb] = 1;
+                } else {
+                    int smaller = P.size(nb) <= P.size(b) ? nb : b;
+                    worklist.push_back(smaller);
+                    inWork[smaller] = 1;
                 }
             }
+            touched.clear();
         }
-        P = std::move(newP);
     }
 
     // ===== 构造新 DFA =====
     DFA newDFA;
-    std::map<DFAState*, DFAState*> rep;
+    newDFA.classes = dfa.classes;
+    newDFA.start = nullptr;
 
-    for (auto& block : P) {
-        DFAState* s = new DFAState();
-        s->id = newDFA.states.size();
+    if (!dfa.start) {
+        return newDFA;
+    }
+
+    // 起始状态就是死状态（没有可匹配的规则）：只保留一个无转移的起始状态
+    int sinkBlock = P.blockOf[sink];
+    int startBlock = P.blockOf[index.at(dfa.start)];
+    if (startBlock == sinkBlock) {
+        newDFA.start = ctx.newDFAState();
+        newDFA.states.push_back(newDFA.start);
+        return newDFA;
+    }
 
-        DFAState* any = *block.begin();
-        s->isAccept = any->isAccept;
-        s->acceptToken = any->acceptToken;
+    // BFS 编号（不可达的块随之丢弃）
+    std::vector<int> newIndex(P.first.size(), -1);
+    std::vector<int> rep;   // 新状态 -> 代表原状态
 
+    auto addBlock = [&](int b) {
+        int i = P.elems[P.first[b]];
+        newIndex[b] = (int)rep.size();
+        rep.push_back(i);
+
+        DFAState* s = ctx.newDFAState();
+        s->id = newIndex[b];
+        s->isAccept = dfa.states[i]->isAccept;
+        s->acceptToken = dfa.states[i]->acceptToken;
         newDFA.states.push_back(s);
+    };
 
-        for (auto* old : block) {
-            rep[old] = s;
+    addBlock(startBlock);
+    for (size_t j = 0; j < rep.size(); ++j) {
+        for (int c = 0; c < k; ++c) {
+            int b = P.blockOf[delta[(size_t)rep[j] * k + c]];
+            if (b != sinkBlock && newIndex[b] < 0) {
+                addBlock(b);
+            }
         }
     }
 
-    // 设置 start
-    newDFA.start = rep[dfa.start];
-
-    // 设置转移
-    for (auto& block : P) {
-        DFAState* from = rep[*block.begin()];
-        DFAState* old = *block.begin();
-
-        for (auto& [ch, to] : old->trans) {
-            from->trans[ch] = rep[to];
+    // 设置转移（指向死状态块的转移省略）
+    for (size_t j = 0; j < rep.size(); ++j) {
+        for (int c = 0; c < k; ++c) {
+            int b = P.blockOf[delta[(size_t)rep[j] * k + c]];
+            if (b != sinkBlock) {
+                newDFA.states[j]->trans[c] = newDFA.states[newIndex[b]];
+            }
         }
     }
 
+    newDFA.start = newDFA.states[0];
     return newDFA;
 }
@@ -1,4 +1,7 @@
 #pragma once
 #include "dfa.h"
 
-DFA minimizeDFA(const DFA& dfa);
+class AutomatonContext;
+
+// 最小化后的 DFA 状态分配在 ctx 中（可以与 dfa 所在的上下文不同）
+DFA minimizeDFA(AutomatonContext& ctx, const DFA& dfa);
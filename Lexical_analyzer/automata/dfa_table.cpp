@@ -0,0 +1,62 @@
+#include "dfa_table.h"
+#include <unordered_map>
+
+DFATable buildDFATable(const DFA& dfa) {
+    DFATable table;
+    table.numStates = (int)dfa.states.size();
+    table.numClasses = dfa.classes.count;
+    table.byteClass = dfa.classes.classOf;
+
+    // DFAState* -> 表中下标
+    std::unordered_map<const DFAState*, int> index;
+    for (int i = 0; i < table.numStates; ++i) {
+        index[dfa.states[i]] = i;
+    }
+
+    table.next.assign((size_t)table.numStates * table.numClasses,
+                      DFATable::DEAD);
+    table.accept.assign(table.numStates, 0);
+    table.acceptToken.assign(table.numStates, TokenType::ERROR);
+
+    for (int i = 0; i < table.numStates; ++i) {
+        const DFAState* s = dfa.states[i];
+
+        table.accept[i] = s->isAccept ? 1 : 0;
+        table.acceptToken[i] = s->acceptToken;
+
+        for (auto& [cls, to] : s->trans) {
+            table.next[(size_t)i * table.numClasses + cls] = index.at(to);
+        }
+    }
+
+    // ===== 自环检测 =====
+    // 收集回到自身的字节，能合并成至多 ByteRanges::MAX 段时才启用加速
+    table.selfLoop.assign(table.numStates, ByteRanges());
+    for (int i = 0; i < table.numStates; ++i) {
+        ByteRanges r;
+        bool fits = true;
+
+        for (int b = 0; b < 256 && fits; ++b) {
+            if (table.step(i, (unsigned char)b) != i) continue;
+
+            if (r.count > 0 && r.hi[r.count - 1] == b - 1) {
+                r.hi[r.count - 1] = (unsigned char)b;
+            } else if (r.count < ByteRanges::MAX) {
+                r.lo[r.count] = r.hi[r.count] = (unsigned char)b;
+                r.count++;
+            } else {
+                fits = false;
+            }
+        }
+
+        if (fits) {
+            table.selfLoop[i] = r;
+        }
+    }
+
+    table.keywords = dfa.keywords;
+    table.kinds = dfa.kinds;
+
+    table.start = dfa.start ? index.at(dfa.start) : DFATable::DEAD;
+    return table;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include "token.h"
+#include "charset.h"
+#include "dfa.h"
+#include "keyword_table.h"
+
+/*
+ * DFATable
+ * ========
+ * 最小化 DFA 的扁平转移表（供 Lexer 运行时使用）
+ *
+ * 布局：
+ * - byteClass[byte]：字节 -> 等价类编号（256 项）
+ * - next[state * numClasses + class]：目标状态下标，DEAD 表示无转移
+ * - accept / acceptToken：按状态下标存放的侧表
+ * - selfLoop[state]：转移回自身的字节集合（可表示为至多 4 段区间时）
+ * - keywords：关键字完美散列（启用时关键字不在表中，先按标识符匹配）
+ * - kinds：Token 种类表（acceptToken 中的编号 -> 名称）
+ *
+ * 每读入一个字节只需一次类映射和一次数组下标访问，
+ * 不再有 std::map 查找和指针跳转；
+ * 按等价类压缩列数后，整张表通常能放进 L1
+ */
+struct DFATable {
+    static constexpr int DEAD = -1;
+
+    int start = DEAD;       // 起始状态下标
+    int numStates = 0;      // 状态数
+    int numClasses = 1;     // 等价类数（表的列数）
+
+    std::array<unsigned char, 256> byteClass{}; // 字节 -> 等价类
+    std::vector<int> next;                  // numStates * numClasses
+    std::vector<unsigned char> accept;      // 是否为接受态
+    std::vector<TokenType> acceptToken;     // 接受态对应的 Token
+
+    // 自环加速：运行时在这些状态上整段扫描，而不是逐字节查表
+    std::vector<ByteRanges> selfLoop;
+
+    // 关键字完美散列：对 idToken 的匹配结果再归类
+    KeywordTable keywords;
+
+    // 规则集定义的 Token 种类
+    TokenKinds kinds;
+
+    // 单步转移
+    int step(int state, unsigned char c) const {
+        return next[(size_t)state * numClasses + byteClass[c]];
+    }
+};
+
+/*
+ * buildDFATable
+ * =============
+ * 将 DFA 指针图降级为连续的转移表
+ * 状态下标即其在 dfa.states 中的位置
+ */
+DFATable buildDFATable(const DFA& dfa);
@@ -0,0 +1,221 @@
+#include "followpos.h"
+#include "automaton_context.h"
+#include "bit_set.h"
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// 子表达式的 nullable / firstpos / lastpos
+struct PosInfo {
+    bool nullable = false;
+    BitSet first;
+    BitSet last;
+};
+
+/*
+ * FollowposBuilder
+ * ================
+ * 先数出位置总数以确定位图宽度，再自底向上计算各集合
+ */
+struct FollowposBuilder {
+    const ByteClasses& classes;
+    PositionAutomaton& pa;
+
+    FollowposBuilder(const ByteClasses& classes, PositionAutomaton& pa)
+        : classes(classes), pa(pa) {}
+
+    // 字符 / 字符类叶结点的出现次数（共享子树按出现次数计）
+    static size_t countLeaves(const RegexNode* node) {
+        if (!node) {
+            throw std::runtime_error("Null regex node");
+        }
+        switch (node->type) {
+            case RegexType::CHAR:
+            case RegexType::CHARSET:  return 1;
+            case RegexType::CONCAT:
+            case RegexType::UNION:    return countLeaves(node->left) + countLeaves(node->right);
+            case RegexType::STAR:
+            case RegexType::PLUS:
+            case RegexType::OPTIONAL: return countLeaves(node->left);
+        }
+        throw std::runtime_error("Unknown regex node type");
+    }
+
+    int newPosition(std::vector<int> cls, TokenType token) {
+        pa.cls.push_back(std::move(cls));
+        pa.token.push_back(token);
+        pa.follow.push_back(makeBitSet(pa.width));
+        return (int)pa.cls.size() - 1;
+    }
+
+    PosInfo leaf(std::vector<int> cls) {
+        PosInfo info;
+        int p = newPosition(std::move(cls), TokenType::ERROR);
+        info.first = info.last = makeBitSet(pa.width);
+        setBit(info.first, p);
+        setBit(info.last, p);
+        return info;
+    }
+
+    PosInfo visit(const RegexNode* node) {
+        PosInfo info;
+
+        switch (node->type) {
+        case RegexType::CHAR:
+            return leaf({classes.of((unsigned char)node->ch)});
+
+        case RegexType::CHARSET: {
+            // 等价类不会跨越集合边界：类的代表字节在集合中即整类在集合中
+            std::vector<int> cls;
+            for (int c = 0; c < classes.count; ++c) {
+                if (node->set.contains(classes.representative[c])) cls.push_back(c);
+            }
+            return leaf(std::move(cls));
+        }
+
+        case RegexType::CONCAT: {
+            PosInfo a = visit(node->left);
+            PosInfo b = visit(node->right);
+
+            forEachBit(a.last, [&](int i) { orInto(pa.follow[i], b.first); });
+
+            info.nullable = a.nullable && b.nullable;
+            info.first = a.first;
+            if (a.nullable) orInto(info.first, b.first);
+            info.last = b.last;
+            if (b.nullable) orInto(info.last, a.last);
+            return info;
+        }
+
+        case RegexType::UNION: {
+            PosInfo a = visit(node->left);
+            PosInfo b = visit(node->right);
+
+            info.nullable = a.nullable || b.nullable;
+            info.first = std::move(a.first);
+            orInto(info.first, b.first);
+            info.last = std::move(a.last);
+            orInto(info.last, b.last);
+            return info;
+        }
+
+        case RegexType::STAR:
+        case RegexType::PLUS: {
+            info = visit(node->left);
+            forEachBit(info.last, [&](int i) { orInto(pa.follow[i], info.first); });
+            if (node->type == RegexType::STAR) info.nullable = true;
+            return info;
+        }
+
+        case RegexType::OPTIONAL: {
+            info = visit(node->left);
+            info.nullable = true;
+            return info;
+        }
+        }
+        throw std::runtime_error("Unknown regex node type");
+    }
+};
+
+} // namespace
+
+bool PositionAutomaton::acceptOf(const BitSet& set, TokenType& tok) const {
+    bool accept = false;
+
+    // 结束标记按规则顺序编号：同优先级时先出现的规则胜出
+    // 与 Thompson 路径一致：Token 为 ERROR 的规则不构成接受态
+    forEachBit(set, [&](int p) {
+        if (!cls[p].empty() || token[p] == TokenType::ERROR) return;
+        if (!accept || tokenPriority(token[p]) < tokenPriority(tok)) {
+            accept = true;
+            tok = token[p];
+        }
+    });
+    return accept;
+}
+
+void PositionAutomaton::successors(const BitSet& set, std::vector<BitSet>& next,
+                                   std::vector<unsigned char>& touched) const {
+    forEachBit(set, [&](int p) {
+        for (int c : cls[p]) {
+            orInto(next[c], follow[p]);
+            touched[c] = 1;
+        }
+    });
+}
+
+PositionAutomaton buildPositionAutomaton(
+    const std::vector<std::pair<TokenType, RegexNode*>>& specs,
+    const ByteClasses& classes
+) {
+    PositionAutomaton pa;
+    FollowposBuilder fb(classes, pa);
+
+    pa.width = specs.size();
+    for (auto& [_, regex] : specs) {
+        pa.width += FollowposBuilder::countLeaves(regex);
+    }
+    pa.cls.reserve(pa.width);
+    pa.token.reserve(pa.width);
+    pa.follow.reserve(pa.width);
+
+    // 起始集合：各规则 firstpos 之并；可匹配空串的规则直接含其结束标记
+    pa.start = makeBitSet(pa.width);
+    for (auto& [tok, regex] : specs) {
+        PosInfo info = fb.visit(regex);
+        int end = fb.newPosition({}, tok);
+
+        forEachBit(info.last, [&](int i) { setBit(pa.follow[i], end); });
+        orInto(pa.start, info.first);
+        if (info.nullable) setBit(pa.start, end);
+    }
+    return pa;
+}
+
+DFA buildDFAFollowpos(
+    AutomatonContext& ctx,
+    const std::vector<std::pair<TokenType, RegexNode*>>& specs,
+    const ByteClasses& classes
+) {
+    PositionAutomaton pa = buildPositionAutomaton(specs, classes);
+
+    DFA dfa;
+    dfa.classes = classes;
+
+    std::unordered_map<BitSet, int, BitSetHash> dfaMap;
+    std::vector<const BitSet*> sets;
+
+    auto addState = [&](BitSet&& set) {
+        auto [it, inserted] = dfaMap.emplace(std::move(set), (int)sets.size());
+        if (inserted) {
+            DFAState* s = ctx.newDFAState();
+            s->id = (int)dfa.states.size();
+            s->isAccept = pa.acceptOf(it->first, s->acceptToken);
+
+            dfa.states.push_back(s);
+            sets.push_back(&it->first);
+        }
+        return it->second;
+    };
+
+    dfa.start = dfa.states[addState(BitSet(pa.start))];
+
+    std::vector<BitSet> next(classes.count, makeBitSet(pa.width));
+    std::vector<unsigned char> touched(classes.count, 0);
+
+    for (size_t cur = 0; cur < sets.size(); ++cur) {
+        pa.successors(*sets[cur], next, touched);
+
+        for (int cls = 0; cls < classes.count; ++cls) {
+            if (!touched[cls]) continue;
+            touched[cls] = 0;
+
+            int to = addState(std::move(next[cls]));
+            next[cls] = makeBitSet(pa.width);
+            dfa.states[cur]->trans[cls] = dfa.states[to];
+        }
+    }
+
+    return dfa;
+}
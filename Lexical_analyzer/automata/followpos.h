@@ -0,0 +1,67 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include "regex_ast.h"
+#include "dfa.h"
+#include "byte_class.h"
+
+#include "bit_set.h"
+
+class AutomatonContext;
+
+/*
+ * PositionAutomaton
+ * =================
+ * 由正则 AST 直接得到的位置自动机（Glushkov NFA，无 ε 边）
+ *
+ * - 位置即 AST 中字符 / 字符类叶结点的每一次出现（共享子树按出现次数分别编号），
+ *   外加每条规则一个结束标记
+ * - 状态集合 S 在字节类 c 上的后继：S 中匹配类 c 的位置的 follow 之并
+ * - S 含结束标记即可接受，按 tokenPriority 取 Token，
+ *   同优先级取靠前的规则（与 Thompson 路径一致）
+ *
+ * 只引用 classes，不引用 AST：构造完成后 AST 即可释放
+ */
+struct PositionAutomaton {
+    size_t width = 0;                 // 位置数（位图宽度）
+    std::vector<std::vector<int>> cls; // 位置 -> 匹配的字节类（升序）；结束标记为空
+    std::vector<TokenType> token;     // 位置 -> 结束标记的 Token
+    std::vector<BitSet> follow;       // 位置 -> followpos
+    BitSet start;                     // 起始集合
+
+    // 集合 set 的接受 Token；不可接受时返回 false
+    bool acceptOf(const BitSet& set, TokenType& tok) const;
+
+    // 集合 set 在各字节类上的后继，写入 next[c]（调用前应为空集）
+    // touched[c] 置 1 表示该类有后继
+    void successors(const BitSet& set, std::vector<BitSet>& next,
+                    std::vector<unsigned char>& touched) const;
+};
+
+/*
+ * buildPositionAutomaton
+ * ======================
+ * nullable / firstpos / lastpos / followpos
+ *
+ * specs:   按规则顺序的 (Token, 正则)，见 buildRegexSpecs
+ * classes: 字节等价类（由同一组 AST 计算）
+ */
+PositionAutomaton buildPositionAutomaton(
+    const std::vector<std::pair<TokenType, RegexNode*>>& specs,
+    const ByteClasses& classes
+);
+
+/*
+ * buildDFAFollowpos
+ * =================
+ * 不经过 Thompson NFA，由正则 AST 直接构造 DFA：
+ * 在位置自动机上做子集构造，DFA 状态即位置集合
+ *
+ * DFA 状态分配在 ctx 中；最小化后与 Thompson + 子集构造的结果完全相同
+ */
+DFA buildDFAFollowpos(
+    AutomatonContext& ctx,
+    const std::vector<std::pair<TokenType, RegexNode*>>& specs,
+    const ByteClasses& classes
+);
@@ -0,0 +1,81 @@
+#include "keyword_table.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+TokenType KeywordTable::classify(std::string_view s, TokenType tok) const {
+    if (tok != idToken || words.empty()) {
+        return tok;
+    }
+
+    uint32_t b = keywordHash(s, 0) % (uint32_t)seeds.size();
+    uint32_t slot = keywordHash(s, seeds[b]) % (uint32_t)words.size();
+
+    return words[slot] == s ? tokens[slot] : tok;
+}
+
+KeywordTable buildKeywordTable(
+    const std::vector<std::pair<std::string, TokenType>>& keywords,
+    TokenType idToken) {
+    KeywordTable table;
+    table.idToken = idToken;
+
+    const uint32_t n = (uint32_t)keywords.size();
+    if (n == 0) {
+        return table;
+    }
+
+    // ===== 1. 分桶 =====
+    const uint32_t numBuckets = (n + 1) / 2;
+    std::vector<std::vector<uint32_t>> buckets(numBuckets);
+    for (uint32_t k = 0; k < n; ++k) {
+        buckets[keywordHash(keywords[k].first, 0) % numBuckets].push_back(k);
+    }
+
+    std::vector<uint32_t> order(numBuckets);
+    for (uint32_t b = 0; b < numBuckets; ++b) order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t x, uint32_t y) {
+        return buckets[x].size() > buckets[y].size();
+    });
+
+    // ===== 2. 逐桶搜索种子 =====
+    table.seeds.assign(numBuckets, 0);
+    table.words.assign(n, std::string());
+    table.tokens.assign(n, idToken);
+    std::vector<char> used(n, 0);
+
+    constexpr uint32_t MAX_SEED = 1u << 24;
+
+    for (uint32_t b : order) {
+        if (buckets[b].empty()) break;
+
+        std::vector<uint32_t> slots;
+        uint32_t seed = 1;
+        for (; seed < MAX_SEED; ++seed) {
+            slots.clear();
+            bool ok = true;
+            for (uint32_t k : buckets[b]) {
+                uint32_t s = keywordHash(keywords[k].first, seed) % n;
+                if (used[s] ||
+                    std::find(slots.begin(), slots.end(), s) != slots.end()) {
+                    ok = false;
+                    break;
+                }
+                slots.push_back(s);
+            }
+            if (ok) break;
+        }
+        if (seed == MAX_SEED) {
+            throw std::runtime_error("Cannot build keyword hash table");
+        }
+
+        table.seeds[b] = seed;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            used[slots[i]] = 1;
+            table.words[slots[i]] = keywords[buckets[b][i]].first;
+            table.tokens[slots[i]] = keywords[buckets[b][i]].second;
+        }
+    }
+
+    return table;
+}
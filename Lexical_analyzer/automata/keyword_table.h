@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "token.h"
+
+/*
+ * KeywordTable
+ * ============
+ * 关键字的最小完美散列表（hash-and-displace）
+ *
+ * 关键字不进入自动机：先按标识符（idToken）匹配，
+ * 再用 classify 查表把 lexeme 归类为关键字 Token
+ *
+ * 查找：
+ *   b    = keywordHash(s, 0) % seeds.size()
+ *   slot = keywordHash(s, seeds[b]) % words.size()
+ *   words[slot] == s ? tokens[slot] : idToken
+ *
+ * 每次查找两次散列 + 一次比较，与关键字个数无关
+ */
+struct KeywordTable {
+    TokenType idToken = TokenType::ERROR;   // 关键字先被匹配成的 Token
+    std::vector<uint32_t> seeds;        // 每个桶的位移种子
+    std::vector<std::string> words;     // 槽位 -> 关键字
+    std::vector<TokenType> tokens;      // 槽位 -> 关键字 Token
+
+    bool empty() const { return words.empty(); }
+
+    // 把标识符归类为关键字；不是关键字时原样返回 tok
+    TokenType classify(std::string_view s, TokenType tok) const;
+};
+
+/*
+ * keywordHash
+ * ===========
+ * 带种子的 FNV-1a（32 位）+ 末尾混合
+ * 生成的扫描器代码中有一份相同的实现，两者必须保持一致
+ */
+constexpr uint32_t keywordHash(std::string_view s, uint32_t seed) {
+    uint32_t h = 0x811c9dc5u ^ (seed * 0x9e3779b9u);
+    for (char c : s) {
+        h ^= (unsigned char)c;
+        h *= 0x01000193u;
+    }
+    h ^= h >> 15;
+    h *= 0x2c1b3c6du;
+    h ^= h >> 12;
+    return h;
+}
+
+/*
+ * buildKeywordTable
+ * =================
+ * 为关键字集合构造最小完美散列（关键字互不相同）
+ *
+ * 桶按大小降序逐个放置：为每个桶搜索一个种子，
+ * 使桶内所有关键字落到互不相同的空槽位
+ */
+KeywordTable buildKeywordTable(
+    const std::vector<std::pair<std::string, TokenType>>& keywords,
+    TokenType idToken);
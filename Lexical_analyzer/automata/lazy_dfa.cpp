@@ -0,0 +1,79 @@
+#include "lazy_dfa.h"
+
+LazyDFA::LazyDFA(PositionAutomaton pa, const ByteClasses& classes,
+                 KeywordTable keywords, TokenKinds kinds, size_t budget)
+    : pa(std::move(pa)), classes(classes), keywords(std::move(keywords)),
+      kinds(std::move(kinds)), numClasses((size_t)classes.count), budget(budget) {
+    classMask.assign(numClasses, makeBitSet(this->pa.width));
+    for (size_t p = 0; p < this->pa.width; ++p) {
+        for (int c : this->pa.cls[p]) {
+            setBit(classMask[c], (int)p);
+        }
+    }
+}
+
+size_t LazyDFA::stateCost() const {
+    return pa.start.size() * sizeof(uint64_t) + numClasses * sizeof(int) + 64;
+}
+
+int LazyDFA::addState(BitSet&& set) {
+    auto [it, inserted] = index.emplace(std::move(set), (int)sets.size());
+    if (inserted) {
+        TokenType tok = TokenType::ERROR;
+        accept.push_back(pa.acceptOf(it->first, tok) ? 1 : 0);
+        acceptTok.push_back(tok);
+        sets.push_back(&it->first);
+        next.resize(next.size() + numClasses, UNKNOWN);
+        used += stateCost();
+    }
+    return it->second;
+}
+
+int LazyDFA::computeStep(int state, int cls) {
+    // 后继：state 中匹配类 cls 的位置的 followpos 之并
+    const BitSet& cur = *sets[state];
+    const BitSet& mask = classMask[cls];
+    BitSet target = makeBitSet(pa.width);
+    bool any = false;
+
+    for (size_t w = 0; w < cur.size(); ++w) {
+        for (uint64_t word = cur[w] & mask[w]; word; word &= word - 1) {
+            orInto(target, pa.follow[w * 64 + __builtin_ctzll(word)]);
+            any = true;
+        }
+    }
+
+    if (!any) {
+        next[(size_t)state * numClasses + cls] = DEAD;
+        return DEAD;
+    }
+
+    // 已有状态：只补一条转移
+    auto it = index.find(target);
+    if (it != index.end()) {
+        next[(size_t)state * numClasses + cls] = it->second;
+        return it->second;
+    }
+
+    // 超出预算：清空后从当前状态重新开始（至少保留当前与目标两个状态）
+    if (used + stateCost() > budget && sets.size() > 1) {
+        BitSet keep = cur;
+        flush();
+        state = addState(std::move(keep));
+    }
+
+    int to = addState(std::move(target));
+    next[(size_t)state * numClasses + cls] = to;
+    return to;
+}
+
+void LazyDFA::flush() {
+    index.clear();
+    sets.clear();
+    next.clear();
+    accept.clear();
+    acceptTok.clear();
+    startState = DEAD;
+    used = 0;
+    flushes++;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "token.h"
+#include "bit_set.h"
+#include "byte_class.h"
+#include "followpos.h"
+#include "keyword_table.h"
+
+/*
+ * LazyDFA
+ * =======
+ * 按需构造的 DFA：保留位置自动机（NFA），扫描时才计算用到的 DFA 状态与转移
+ *
+ * - 状态 = 位置集合；转移按 (状态, 字节类) 首次用到时计算并缓存
+ * - 缓存有内存预算：新状态放不下时整体清空，从当前状态重新开始
+ *   （与 RE2 的做法相同），因此内存占用只取决于预算，与规则集大小无关
+ * - 不做最小化；匹配结果与完整构造的转移表相同
+ *
+ * 状态下标只在下一次 step() / start() 之前有效（清空后会重新编号），
+ * 调用方不应跨步保存
+ *
+ * 缓存在扫描过程中被修改，同一个 LazyDFA 不能在多个线程中同时使用
+ */
+class LazyDFA {
+public:
+    static constexpr int DEAD = -1;
+    static constexpr size_t DEFAULT_BUDGET = 1 << 20;   // 1 MB
+
+    // pa:       位置自动机（规则 → 正则 → followpos）
+    // classes:  字节等价类
+    // keywords: 关键字完美散列（未启用时为空）
+    // kinds:    规则集定义的 Token 种类
+    // budget:   状态缓存的内存预算（字节）
+    LazyDFA(PositionAutomaton pa, const ByteClasses& classes,
+            KeywordTable keywords, TokenKinds kinds,
+            size_t budget = DEFAULT_BUDGET);
+
+    LazyDFA(const LazyDFA&) = delete;
+    LazyDFA& operator=(const LazyDFA&) = delete;
+    LazyDFA(LazyDFA&&) = default;
+
+    // 起始状态
+    int start() {
+        if (startState == DEAD) startState = addState(BitSet(pa.start));
+        return startState;
+    }
+
+    // 单步转移；无转移时返回 DEAD
+    int step(int state, unsigned char c) {
+        int t = next[(size_t)state * numClasses + classes.of(c)];
+        return t != UNKNOWN ? t : computeStep(state, classes.of(c));
+    }
+
+    bool isAccept(int state) const { return accept[state] != 0; }
+    TokenType acceptToken(int state) const { return acceptTok[state]; }
+
+    const ByteClasses& byteClasses() const { return classes; }
+    const KeywordTable& keywordTable() const { return keywords; }
+    const TokenKinds& tokenKinds() const { return kinds; }
+
+    // 统计
+    size_t stateCount() const { return sets.size(); }
+    size_t memoryUsed() const { return used; }
+    size_t flushCount() const { return flushes; }
+
+private:
+    static constexpr int UNKNOWN = -2;
+
+    PositionAutomaton pa;
+    ByteClasses classes;
+    KeywordTable keywords;
+    TokenKinds kinds;
+    size_t numClasses;
+    std::vector<BitSet> classMask;     // 字节类 -> 该类的位置集合
+
+    // 状态缓存
+    std::unordered_map<BitSet, int, BitSetHash> index;
+    std::vector<const BitSet*> sets;   // 状态 -> 位置集合（index 中的键）
+    std::vector<int> next;             // 状态 * numClasses + 类 -> 状态 / DEAD / UNKNOWN
+    std::vector<unsigned char> accept;
+    std::vector<TokenType> acceptTok;
+    int startState = DEAD;
+
+    size_t budget;
+    size_t used = 0;
+    size_t flushes = 0;
+
+    // 一个状态占用的字节数（位置集合 + 转移行 + 散列表结点的估计开销）
+    size_t stateCost() const;
+
+    // 找到或加入状态（不检查预算）
+    int addState(BitSet&& set);
+
+    // 计算并缓存一条转移，必要时先清空缓存
+    int computeStep(int state, int cls);
+
+    // 清空全部缓存状态
+    void flush();
+};
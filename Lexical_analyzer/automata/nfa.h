@@ -3,7 +3,9 @@
 #include <map>
 #include <vector>
 #include <set>
+#include <utility>
 #include "token.h"
+#include "charset.h"
 
 /*
  * State
@@ -11,11 +13,14 @@
  * NFA 状态结点
  */
 struct State {
-    int id;   // 状态编号（仅用于调试 / 打印）
+    int id = 0;   // 状态编号（仅用于调试 / 打印，同一上下文内递增）
 
     // 字符转移：ch -> 多个目标状态
     std::map<char, std::vector<State*>> trans;
 
+    // 字符类转移：一条边覆盖整个字节集合
+    std::vector<std::pair<ByteSet, State*>> sets;
+
     // ε 转移
     std::vector<State*> eps;
 
@@ -34,10 +39,4 @@ struct NFA {
     State* accept;
 };
 
-/*
- * newState
- * ========
- * 创建一个新的 NFA 状态
- * id 自动递增，便于调试
- */
-State* newState();
+// NFA 状态由 AutomatonContext::newState() 分配（见 automaton_context.h）
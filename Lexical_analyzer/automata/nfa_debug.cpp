@@ -20,6 +20,21 @@ static void dfsPrint(State* s, std::set<State*>& visited) {
         }
     }
 
+    // 字符类转移（按区间打印）
+    for (auto& [set, t] : s->sets) {
+        std::cout << "S" << s->id << " --[";
+        for (int lo = 0; lo < 256; ++lo) {
+            if (!set.contains((unsigned char)lo)) continue;
+            int hi = lo;
+            while (hi + 1 < 256 && set.contains((unsigned char)(hi + 1))) ++hi;
+            std::cout << lo;
+            if (hi > lo) std::cout << "-" << hi;
+            std::cout << " ";
+            lo = hi;
+        }
+        std::cout << "]--> S" << t->id << "\n";
+    }
+
     // ε 转移
     for (auto* t : s->eps) {
         std::cout << "S" << s->id
@@ -32,6 +47,9 @@ static void dfsPrint(State* s, std::set<State*>& visited) {
         for (auto* t : targets)
             dfsPrint(t, visited);
 
+    for (auto& [_, t] : s->sets)
+        dfsPrint(t, visited);
+
     for (auto* t : s->eps)
         dfsPrint(t, visited);
 }
@@ -1,15 +1,21 @@
 #pragma once
 
+#include "charset.h"
+
 /*
  * RegexType
  * =========
  * Thompson 构造法所需的最小正则算子集合
+ * 外加字符类与 + / ?（可由前四种展开，单列出来以免结点与状态数膨胀）
  */
 enum class RegexType {
     CHAR,     // 单字符 a
     CONCAT,   // 连接 ab
     UNION,    // 或 a|b
-    STAR      // 闭包 a*
+    STAR,     // 闭包 a*
+    CHARSET,  // 字符类 [a-z]（一条边匹配集合中任一字节）
+    PLUS,     // 正闭包 a+
+    OPTIONAL  // 可选 a?
 };
 
 /*
@@ -23,6 +29,9 @@ struct RegexNode {
     // 仅 CHAR 使用
     char ch = 0;
 
+    // 仅 CHARSET 使用
+    ByteSet set;
+
     // 子结点
     RegexNode* left = nullptr;
     RegexNode* right = nullptr;
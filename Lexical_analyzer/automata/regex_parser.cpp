@@ -0,0 +1,331 @@
+#include "regex_parser.h"
+#include "automaton_context.h"
+#include "thompson.h"
+#include <stdexcept>
+
+namespace {
+
+constexpr int MAX_REPEAT = 255;
+
+/*
+ * RegexParser
+ * ===========
+ * 递归下降：
+ *   alt    := concat ('|' concat)*
+ *   concat := repeat+
+ *   repeat := atom ('*' | '+' | '?' | '{' n [',' [m]] '}')*
+ *   atom   := char | '.' | class | escape | '(' alt ')'
+ *
+ * 每个子表达式同时返回是否可空（nullable），用于拒绝匹配空串的规则
+ */
+class RegexParser {
+public:
+    RegexParser(AutomatonContext& ctx, const std::string& text)
+        : ctx(ctx), text(text) {}
+
+    RegexNode* parse() {
+        bool nullable = false;
+        RegexNode* node = parseAlt(nullable);
+        if (pos < text.size()) {
+            fail(text[pos] == ')' ? "unmatched ')'" : "unexpected character");
+        }
+        if (nullable) {
+            fail("pattern matches the empty string");
+        }
+        return node;
+    }
+
+private:
+    AutomatonContext& ctx;
+    const std::string& text;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const std::string& message) const {
+        throw std::runtime_error("Invalid regex /" + text + "/: " + message +
+                                 " at position " + std::to_string(pos));
+    }
+
+    bool atEnd() const { return pos >= text.size(); }
+    char peek() const { return text[pos]; }
+
+    RegexNode* parseAlt(bool& nullable) {
+        RegexNode* node = parseConcat(nullable);
+        while (!atEnd() && peek() == '|') {
+            pos++;
+            bool rightNullable = false;
+            RegexNode* right = parseConcat(rightNullable);
+            node = ctx.newRegex(RegexType::UNION, 0, node, right);
+            nullable = nullable || rightNullable;
+        }
+        return node;
+    }
+
+    RegexNode* parseConcat(bool& nullable) {
+        RegexNode* node = nullptr;
+        nullable = true;
+
+        while (!atEnd() && peek() != '|' && peek() != ')') {
+            bool itemNullable = false;
+            RegexNode* item = parseRepeat(itemNullable);
+            node = node ? ctx.newRegex(RegexType::CONCAT, 0, node, item) : item;
+            nullable = nullable && itemNullable;
+        }
+
+        if (!node) {
+            fail("empty expression");
+        }
+        return node;
+    }
+
+    RegexNode* parseRepeat(bool& nullable) {
+        RegexNode* node = parseAtom(nullable);
+
+        while (!atEnd()) {
+            char c = peek();
+            if (c == '*') {
+                pos++;
+                node = ctx.newRegex(RegexType::STAR, 0, node);
+                nullable = true;
+            } else if (c == '+') {
+                pos++;
+                node = ctx.newRegex(RegexType::PLUS, 0, node);
+            } else if (c == '?') {
+                pos++;
+                node = ctx.newRegex(RegexType::OPTIONAL, 0, node);
+                nullable = true;
+            } else if (c == '{') {
+                pos++;
+                node = parseBounds(node, nullable);
+            } else {
+                break;
+            }
+        }
+        return node;
+    }
+
+    int parseNumber() {
+        if (atEnd() || !isDigit((unsigned char)peek())) {
+            fail("expected a repeat count");
+        }
+        int n = 0;
+        while (!atEnd() && isDigit((unsigned char)peek())) {
+            n = n * 10 + (peek() - '0');
+            if (n > MAX_REPEAT) {
+                fail("repeat count exceeds " + std::to_string(MAX_REPEAT));
+            }
+            pos++;
+        }
+        return n;
+    }
+
+    /*
+     * a{n,m} 展开为 n 个 a 后接 (a(a...)?)?，a{n,} 展开为 n 个 a 后接 a*
+     * 展开后的各处出现共享同一个子树：Thompson 与 followpos
+     * 都按出现次数分别构造，共享不影响结果
+     */
+    RegexNode* parseBounds(RegexNode* node, bool& nullable) {
+        int lo = parseNumber();
+        int hi = lo;
+        bool unbounded = false;
+        if (!atEnd() && peek() == ',') {
+            pos++;
+            if (!atEnd() && peek() == '}') {
+                unbounded = true;
+            } else {
+                hi = parseNumber();
+            }
+        }
+        if (atEnd() || peek() != '}') {
+            fail("expected '}'");
+        }
+        pos++;
+
+        if (!unbounded && hi < lo) {
+            fail("repeat bounds out of order");
+        }
+        if (!unbounded && hi == 0) {
+            fail("repeat count must be positive");
+        }
+
+        RegexNode* tail = nullptr;
+        if (unbounded) {
+            tail = ctx.newRegex(RegexType::STAR, 0, node);
+        } else {
+            for (int i = lo; i < hi; ++i) {
+                tail = ctx.newRegex(
+                    RegexType::OPTIONAL, 0,
+                    tail ? ctx.newRegex(RegexType::CONCAT, 0, node, tail) : node);
+            }
+        }
+
+        RegexNode* result = tail;
+        for (int i = 0; i < lo; ++i) {
+            result = result ? ctx.newRegex(RegexType::CONCAT, 0, node, result) : node;
+        }
+
+        nullable = nullable || lo == 0;
+        return result;
+    }
+
+    RegexNode* parseAtom(bool& nullable) {
+        if (atEnd()) {
+            fail("unexpected end of pattern");
+        }
+
+        char c = peek();
+        switch (c) {
+        case '(': {
+            pos++;
+            RegexNode* node = parseAlt(nullable);
+            if (atEnd() || peek() != ')') {
+                fail("expected ')'");
+            }
+            pos++;
+            return node;
+        }
+        case '[':
+            pos++;
+            nullable = false;
+            return buildCharSet(ctx, parseClass());
+        case '.': {
+            pos++;
+            nullable = false;
+            ByteSet any;
+            any.add('\n');
+            any.invert();
+            return buildCharSet(ctx, any);
+        }
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            fail(std::string("nothing to repeat before '") + c + "'");
+        case '\\': {
+            pos++;
+            nullable = false;
+            ByteSet set;
+            int ch = parseEscape(set);
+            return ch >= 0 ? ctx.newRegex(RegexType::CHAR, (char)ch)
+                           : buildCharSet(ctx, set);
+        }
+        default:
+            pos++;
+            nullable = false;
+            return ctx.newRegex(RegexType::CHAR, c);
+        }
+    }
+
+    static int hexValue(char c) {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    }
+
+    /*
+     * '\' 之后的转义：单个字节时返回该字节，
+     * 类转义（\d \w \s 及大写形式）写入 set 并返回 -1
+     */
+    int parseEscape(ByteSet& set) {
+        if (atEnd()) {
+            fail("trailing '\\'");
+        }
+
+        char c = text[pos++];
+        switch (c) {
+        case 'n': return '\n';
+        case 't': return '\t';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        case '0': return '\0';
+        case 'x': {
+            int hi = pos < text.size() ? hexValue(text[pos]) : -1;
+            int lo = pos + 1 < text.size() ? hexValue(text[pos + 1]) : -1;
+            if (hi < 0 || lo < 0) {
+                fail("expected two hex digits after \\x");
+            }
+            pos += 2;
+            return hi * 16 + lo;
+        }
+        case 'd': case 'D':
+            set.addRange('0', '9');
+            break;
+        case 'w': case 'W':
+            for (int b = 0; b < 256; ++b) {
+                if (isIdentChar((unsigned char)b)) set.add((unsigned char)b);
+            }
+            break;
+        case 's': case 'S':
+            set.add(' ');
+            set.addRange('\t', '\r');   // \t \n \v \f \r
+            break;
+        default:
+            return (unsigned char)c;
+        }
+
+        if (c == 'D' || c == 'W' || c == 'S') {
+            set.invert();
+        }
+        return -1;
+    }
+
+    // '[' 之后直到 ']'
+    ByteSet parseClass() {
+        ByteSet set;
+        bool negate = false;
+        if (!atEnd() && peek() == '^') {
+            negate = true;
+            pos++;
+        }
+
+        bool first = true;
+        while (true) {
+            if (atEnd()) {
+                fail("unterminated character class");
+            }
+            if (peek() == ']' && !first) {
+                pos++;
+                break;
+            }
+            first = false;
+
+            int lo = parseClassChar(set);
+            if (lo < 0) continue;   // 类转义已并入 set
+
+            // 区间 a-z；'-' 在结尾时是字面量
+            if (pos + 1 < text.size() && peek() == '-' && text[pos + 1] != ']') {
+                pos++;
+                int hi = parseClassChar(set);
+                if (hi < 0) {
+                    fail("character class escape cannot end a range");
+                }
+                if (hi < lo) {
+                    fail("character range out of order");
+                }
+                set.addRange((unsigned char)lo, (unsigned char)hi);
+            } else {
+                set.add((unsigned char)lo);
+            }
+        }
+
+        if (negate) {
+            set.invert();
+        }
+        if (set.empty()) {
+            fail("empty character class");
+        }
+        return set;
+    }
+
+    int parseClassChar(ByteSet& set) {
+        char c = text[pos++];
+        return c == '\\' ? parseEscape(set) : (unsigned char)c;
+    }
+};
+
+} // namespace
+
+RegexNode* parseRegex(AutomatonContext& ctx, const std::string& pattern) {
+    return RegexParser(ctx, pattern).parse();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include "regex_ast.h"
+
+class AutomatonContext;
+
+/*
+ * parseRegex
+ * ==========
+ * 正则表达式文本 → 正则 AST（结点分配在 ctx 中）
+ *
+ * 语法（优先级由低到高）：
+ *   a|b           或
+ *   ab            连接
+ *   a* a+ a?      闭包 / 正闭包 / 可选
+ *   a{n} a{n,} a{n,m}
+ *                 重复（0 <= n <= m <= 255，m > 0），展开为 n 个 a 加可选尾部
+ *   (a)           分组
+ *   [a-z_] [^\n]  字符类 / 取反字符类（']' 放在开头或转义即为字面量）
+ *   .             除 '\n' 外的任意字节
+ *   \d \w \s      数字 / 标识符字符 / 空白，大写形式为其补集
+ *   \n \t \r \f \v \0 \xHH
+ *                 控制字符与十六进制字节
+ *   \c            其他字符转义后即字面量，如 \. \* \/ \\
+ *
+ * 字符类一律降为单个 CHARSET 结点（NFA 上只有一条边）
+ *
+ * 不接受空表达式、空分支、空字符类，也不接受能匹配空串的整条规则
+ * （词法分析器不会产生空 token，这样的规则必然是写错了）
+ * 出错时抛出 std::runtime_error，消息中带出错位置
+ */
+RegexNode* parseRegex(AutomatonContext& ctx, const std::string& pattern);
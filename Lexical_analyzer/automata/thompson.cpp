@@ -1,4 +1,5 @@
 #include "thompson.h"
+#include "regex_parser.h"
 #include <stdexcept>
 
 /*
@@ -6,31 +7,38 @@
  * ===============
  * Regex AST -> NFA
  */
-NFA buildNFA(RegexNode* node) {
+NFA buildNFA(AutomatonContext& ctx, RegexNode* node) {
     if (!node) {
         throw std::runtime_error("Null regex node");
     }
 
     switch (node->type) {
     case RegexType::CHAR: {
-        State* s = newState();
-        State* t = newState();
+        State* s = ctx.newState();
+        State* t = ctx.newState();
         s->trans[node->ch].push_back(t);
         return {s, t};
     }
 
+    case RegexType::CHARSET: {
+        State* s = ctx.newState();
+        State* t = ctx.newState();
+        s->sets.push_back({node->set, t});
+        return {s, t};
+    }
+
     case RegexType::CONCAT: {
-        NFA a = buildNFA(node->left);
-        NFA b = buildNFA(node->right);
+        NFA a = buildNFA(ctx, node->left);
+        NFA b = buildNFA(ctx, node->right);
         a.accept->eps.push_back(b.start);
         return {a.start, b.accept};
     }
 
     case RegexType::UNION: {
-        State* s = newState();
-        State* t = newState();
-        NFA a = buildNFA(node->left);
-        NFA b = buildNFA(node->right);
+        State* s = ctx.newState();
+        State* t = ctx.newState();
+        NFA a = buildNFA(ctx, node->left);
+        NFA b = buildNFA(ctx, node->right);
 
         s->eps.push_back(a.start);
         s->eps.push_back(b.start);
@@ -41,9 +49,9 @@ NFA buildNFA(RegexNode* node) {
     }
 
     case RegexType::STAR: {
-        State* s = newState();
-        State* t = newState();
-        NFA a = buildNFA(node->left);
+        State* s = ctx.newState();
+        State* t = ctx.newState();
+        NFA a = buildNFA(ctx, node->left);
 
         s->eps.push_back(a.start);
         s->eps.push_back(t);
@@ -53,83 +61,102 @@ NFA buildNFA(RegexNode* node) {
         return {s, t};
     }
 
+    case RegexType::PLUS: {
+        // 与 STAR 相同，只是没有跳过 a 的 ε 边
+        State* s = ctx.newState();
+        State* t = ctx.newState();
+        NFA a = buildNFA(ctx, node->left);
+
+        s->eps.push_back(a.start);
+        a.accept->eps.push_back(a.start);
+        a.accept->eps.push_back(t);
+
+        return {s, t};
+    }
+
+    case RegexType::OPTIONAL: {
+        State* s = ctx.newState();
+        State* t = ctx.newState();
+        NFA a = buildNFA(ctx, node->left);
+
+        s->eps.push_back(a.start);
+        s->eps.push_back(t);
+        a.accept->eps.push_back(t);
+
+        return {s, t};
+    }
+
     default:
         throw std::runtime_error("Unknown regex node type");
     }
 }
 
 
-RegexNode* buildKeyword(const std::string& s) {
+RegexNode* buildKeyword(AutomatonContext& ctx, const std::string& s) {
     if (s.empty()) return nullptr;
 
-    RegexNode* node = new RegexNode(RegexType::CHAR, s[0]);
+    RegexNode* node = ctx.newRegex(RegexType::CHAR, s[0]);
     for (size_t i = 1; i < s.size(); ++i) {
-        node = new RegexNode(
+        node = ctx.newRegex(
             RegexType::CONCAT, 0,
             node,
-            new RegexNode(RegexType::CHAR, s[i])
+            ctx.newRegex(RegexType::CHAR, s[i])
         );
     }
     return node;
 }
 
-RegexNode* buildCharSet(const std::vector<char>& chars) {
+RegexNode* buildCharSet(AutomatonContext& ctx, const std::vector<char>& chars) {
     if (chars.empty()) return nullptr;
 
-    RegexNode* node = new RegexNode(RegexType::CHAR, chars[0]);
-    for (size_t i = 1; i < chars.size(); ++i) {
-        node = new RegexNode(
-            RegexType::UNION, 0,
-            node,
-            new RegexNode(RegexType::CHAR, chars[i])
-        );
-    }
+    ByteSet set;
+    for (char c : chars) set.add((unsigned char)c);
+    return buildCharSet(ctx, set);
+}
+
+RegexNode* buildCharSet(AutomatonContext& ctx, const ByteSet& set) {
+    RegexNode* node = ctx.newRegex(RegexType::CHARSET);
+    node->set = set;
     return node;
 }
 
-RegexNode* buildIDRegex() {
-    std::vector<char> head;
-    for (char c = 'a'; c <= 'z'; ++c) head.push_back(c);
-    for (char c = 'A'; c <= 'Z'; ++c) head.push_back(c);
-    head.push_back('_');
+RegexNode* buildIDRegex(AutomatonContext& ctx) {
+    ByteSet head;
+    head.addRange('a', 'z');
+    head.addRange('A', 'Z');
+    head.add('_');
 
-    std::vector<char> tail = head;
-    for (char c = '0'; c <= '9'; ++c) tail.push_back(c);
+    ByteSet tail = head;
+    tail.addRange('0', '9');
 
-    RegexNode* headNode = buildCharSet(head);
-    RegexNode* tailNode = new RegexNode(
+    RegexNode* headNode = buildCharSet(ctx, head);
+    RegexNode* tailNode = ctx.newRegex(
         RegexType::STAR, 0,
-        buildCharSet(tail)
+        buildCharSet(ctx, tail)
     );
 
-    return new RegexNode(
+    return ctx.newRegex(
         RegexType::CONCAT, 0,
         headNode,
         tailNode
     );
 }
 
-RegexNode* buildNUMRegex() {
-    std::vector<char> digits;
-    for (char c = '0'; c <= '9'; ++c) digits.push_back(c);
-
-    RegexNode* digit = buildCharSet(digits);
+RegexNode* buildNUMRegex(AutomatonContext& ctx) {
+    ByteSet digits;
+    digits.addRange('0', '9');
 
-    // [0-9]+  =>  [0-9][0-9]*
-    return new RegexNode(
-        RegexType::CONCAT, 0,
-        digit,
-        new RegexNode(RegexType::STAR, 0, digit)
-    );
+    return ctx.newRegex(RegexType::PLUS, 0, buildCharSet(ctx, digits));
 }
 
 State* buildMasterNFA(
+    AutomatonContext& ctx,
     const std::vector<std::pair<TokenType, RegexNode*>>& specs
 ) {
-    State* start = newState();
+    State* start = ctx.newState();
 
     for (auto& [tok, regex] : specs) {
-        NFA nfa = buildNFA(regex);
+        NFA nfa = buildNFA(ctx, regex);
         nfa.accept->acceptToken = tok;
         start->eps.push_back(nfa.start);
     }
@@ -138,31 +165,47 @@ State* buildMasterNFA(
 
 
 /*
- * buildNFAFromRules
- * =================
- * 根据 RuleSet（来自 .lex）构造总 NFA
+ * buildRegexSpecs
+ * ===============
+ * 根据 RuleSet（来自 .lex）为每条规则构造正则 AST，保持规则顺序
  */
-State* buildNFAFromRules(const RuleSet& rules) {
+std::vector<std::pair<TokenType, RegexNode*>> buildRegexSpecs(
+    AutomatonContext& ctx,
+    const RuleSet& rules
+) {
     std::vector<std::pair<TokenType, RegexNode*>> specs;
 
     for (const auto& rule : rules.rules) {
         RegexNode* regex = nullptr;
 
+        // ===== 正则 /.../ =====
+        if (rule.regex) {
+            regex = parseRegex(ctx, rule.pattern);
+        }
         // ===== 特殊模式 =====
-        if (rule.pattern == "{ID}") {
-            regex = buildIDRegex();
+        else if (rule.pattern == "{ID}") {
+            regex = buildIDRegex(ctx);
         }
         else if (rule.pattern == "{NUM}") {
-            regex = buildNUMRegex();
+            regex = buildNUMRegex(ctx);
         }
         // ===== 关键字或字面量 =====
         else {
             // 对于 "if" "+" "==" 等
-            regex = buildKeyword(rule.pattern);
+            regex = buildKeyword(ctx, rule.pattern);
         }
 
         specs.push_back({rule.type, regex});
     }
 
-    return buildMasterNFA(specs);
+    return specs;
+}
+
+/*
+ * buildNFAFromRules
+ * =================
+ * 根据 RuleSet（来自 .lex）构造总 NFA
+ */
+State* buildNFAFromRules(AutomatonContext& ctx, const RuleSet& rules) {
+    return buildMasterNFA(ctx, buildRegexSpecs(ctx, rules));
 }
@@ -4,8 +4,21 @@
 #include "nfa.h"
 #include "token.h"
 #include "lexer_rule.h"   // 为 RuleSet
+#include "automaton_context.h"
 
-State* buildNFAFromRules(const RuleSet& rules);
+/*
+ * 以下函数构造的 AST 结点与 NFA 状态都分配在 ctx 中，
+ * 结果不能比 ctx 活得久
+ */
+
+// 规则 → 正则 AST（按规则顺序，与 buildDFAFollowpos 共用）
+std::vector<std::pair<TokenType, RegexNode*>> buildRegexSpecs(
+    AutomatonContext& ctx,
+    const RuleSet& rules
+);
+
+// 规则 → 总 NFA
+State* buildNFAFromRules(AutomatonContext& ctx, const RuleSet& rules);
 
 /*
  * buildNFA
@@ -13,7 +26,7 @@ State* buildNFAFromRules(const RuleSet& rules);
  * Thompson 构造法核心：
  * 将正则 AST 转换为 NFA
  */
-NFA buildNFA(RegexNode* node);
+NFA buildNFA(AutomatonContext& ctx, RegexNode* node);
 
 /*
  * ===== 下面是“正则构造工具函数” =====
@@ -22,16 +35,17 @@ NFA buildNFA(RegexNode* node);
  */
 
 // 关键字：如 "int" / "while"
-RegexNode* buildKeyword(const std::string& s);
+RegexNode* buildKeyword(AutomatonContext& ctx, const std::string& s);
 
-// 字符集合：[a-zA-Z_] / [0-9]
-RegexNode* buildCharSet(const std::vector<char>& chars);
+// 字符集合：[a-zA-Z_] / [0-9]，构造为单个 CHARSET 结点
+RegexNode* buildCharSet(AutomatonContext& ctx, const std::vector<char>& chars);
+RegexNode* buildCharSet(AutomatonContext& ctx, const ByteSet& set);
 
 // 标识符：ID = [a-zA-Z_][a-zA-Z0-9_]*
-RegexNode* buildIDRegex();
+RegexNode* buildIDRegex(AutomatonContext& ctx);
 
 // 整数常量：NUM = [0-9]+
-RegexNode* buildNUMRegex();
+RegexNode* buildNUMRegex(AutomatonContext& ctx);
 
 
 
@@ -41,5 +55,6 @@ RegexNode* buildNUMRegex();
  * 将多个 token 的 NFA 合并为一个总入口
  */
 State* buildMasterNFA(
+    AutomatonContext& ctx,
     const std::vector<std::pair<TokenType, RegexNode*>>& specs
 );
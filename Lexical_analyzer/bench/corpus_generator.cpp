@@ -0,0 +1,275 @@
+#include "corpus_generator.h"
+
+#include <cctype>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+// splitmix64：输出只取决于种子，保证语料可复现
+struct Random {
+    uint64_t state;
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // [0, n)
+    size_t below(size_t n) { return (size_t)(next() % n); }
+};
+
+bool identLike(const std::string& s) {
+    if (s.empty() || !(std::isalpha((unsigned char)s[0]) || s[0] == '_')) {
+        return false;
+    }
+    for (char c : s) {
+        if (!(std::isalnum((unsigned char)c) || c == '_')) return false;
+    }
+    return true;
+}
+
+/*
+ * PatternSampler
+ * ==============
+ * 正则规则的样本：在转移表上从起始状态随机游走，停在接受该 Token 的状态
+ *
+ * - 只走可打印、非空白的 ASCII 字节，样本与分隔符不会粘连
+ * - dist[state]：到"可停下"状态的最少步数（-1 表示到不了）
+ * - 可停下：接受该 Token，且读入空白后再也到不了接受态，
+ *   这样 Longest Match 恰好在样本末尾结束，token 数与生成时一致
+ * - 样本长到 MAX_PATTERN_LEN 后只沿 dist 递减的边走，保证结束
+ */
+constexpr size_t MAX_PATTERN_LEN = 12;
+
+struct PatternSampler {
+    TokenType token;
+    std::vector<int> dist;
+};
+
+// 每个状态上可打印字节的出边（字节, 目标状态）
+using Moves = std::vector<std::vector<std::pair<char, int>>>;
+
+Moves printableMoves(const DFATable& table) {
+    Moves moves(table.numStates);
+    for (int s = 0; s < table.numStates; ++s) {
+        for (int c = '!'; c <= '~'; ++c) {
+            int t = table.step(s, (unsigned char)c);
+            if (t != DFATable::DEAD) moves[s].push_back({(char)c, t});
+        }
+    }
+    return moves;
+}
+
+// 反向 BFS：从 targets 出发，沿 moves 的反向边求最短步数
+std::vector<int> distanceTo(const Moves& moves, const std::vector<int>& targets) {
+    std::vector<std::vector<int>> reverse(moves.size());
+    for (size_t s = 0; s < moves.size(); ++s) {
+        for (const auto& m : moves[s]) reverse[m.second].push_back((int)s);
+    }
+
+    std::vector<int> dist(moves.size(), -1);
+    std::deque<int> queue;
+    for (int s : targets) {
+        dist[s] = 0;
+        queue.push_back(s);
+    }
+    while (!queue.empty()) {
+        int s = queue.front();
+        queue.pop_front();
+        for (int p : reverse[s]) {
+            if (dist[p] < 0) {
+                dist[p] = dist[s] + 1;
+                queue.push_back(p);
+            }
+        }
+    }
+    return dist;
+}
+
+// 为每个正则规则的 Token 准备游走距离；抽不出样本的放进 skipped
+std::vector<PatternSampler> patternSamplers(const std::vector<TokenType>& tokens,
+                                            const DFATable& table,
+                                            const Moves& moves,
+                                            std::vector<TokenType>& skipped) {
+    // 能经任意字节到达接受态的状态
+    std::vector<int> accepting;
+    for (int s = 0; s < table.numStates; ++s) {
+        if (table.accept[s]) accepting.push_back(s);
+    }
+    Moves all(table.numStates);
+    for (int s = 0; s < table.numStates; ++s) {
+        for (int c = 0; c < 256; ++c) {
+            int t = table.step(s, (unsigned char)c);
+            if (t != DFATable::DEAD) all[s].push_back({(char)c, t});
+        }
+    }
+    std::vector<int> live = distanceTo(all, accepting);
+
+    auto separated = [&](int s) {
+        for (unsigned char c : {' ', '\t', '\n'}) {
+            int t = table.step(s, c);
+            if (t != DFATable::DEAD && live[t] >= 0) return false;
+        }
+        return true;
+    };
+
+    std::vector<PatternSampler> samplers;
+    for (TokenType token : tokens) {
+        std::vector<int> stops;
+        for (int s = 0; s < table.numStates; ++s) {
+            if (table.accept[s] && table.acceptToken[s] == token && separated(s)) {
+                stops.push_back(s);
+            }
+        }
+
+        PatternSampler sampler{token, distanceTo(moves, stops)};
+        if (table.start == DFATable::DEAD || sampler.dist[table.start] < 0) {
+            skipped.push_back(token);
+        } else {
+            samplers.push_back(std::move(sampler));
+        }
+    }
+    return samplers;
+}
+
+const char IDENT_HEAD[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_";
+const char IDENT_TAIL[] =
+    "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+
+} // namespace
+
+Corpus generateCorpus(const RuleSet& rules, const DFATable& table,
+                      const CorpusOptions& options) {
+    // ===== 按类别整理规则 =====
+    bool hasIdent = false, hasNumber = false;
+    std::vector<std::string> keywords, symbols;
+    std::vector<TokenType> patternTokens;
+
+    for (const auto& rule : rules.rules) {
+        if (rule.regex) {
+            // 同名规则共用一个 Token，只抽一次
+            bool seen = false;
+            for (TokenType t : patternTokens) seen = seen || t == rule.type;
+            if (!seen) patternTokens.push_back(rule.type);
+        } else if (rule.pattern == "{ID}") {
+            hasIdent = true;
+        } else if (rule.pattern == "{NUM}") {
+            hasNumber = true;
+        } else if (identLike(rule.pattern)) {
+            keywords.push_back(rule.pattern);
+        } else {
+            symbols.push_back(rule.pattern);
+        }
+    }
+
+    // 正则规则在转移表上游走抽样，与字面量符号同属 symbol 类
+    Moves moves = printableMoves(table);
+    std::vector<TokenType> skipped;
+    std::vector<PatternSampler> patterns =
+        patternSamplers(patternTokens, table, moves, skipped);
+    if (!skipped.empty()) {
+        std::cerr << "Warning: corpus skips regex rule(s) with no standalone "
+                     "sample:";
+        for (TokenType t : skipped) std::cerr << ' ' << rules.kinds.name(t);
+        std::cerr << '\n';
+    }
+    const size_t symbolCount = symbols.size() + patterns.size();
+
+    // 缺席的类别权重记 0
+    unsigned weights[4] = {
+        hasIdent ? options.mix.ident : 0,
+        hasNumber ? options.mix.number : 0,
+        keywords.empty() ? 0 : options.mix.keyword,
+        symbolCount == 0 ? 0 : options.mix.symbol,
+    };
+    unsigned total = weights[0] + weights[1] + weights[2] + weights[3];
+    if (total == 0) {
+        throw std::runtime_error("Token mix selects no rule of this rule set");
+    }
+
+    // ===== 逐个抽取 token =====
+    Random rng{options.seed};
+    Corpus corpus;
+    corpus.text.reserve(options.bytes + 64);
+
+    unsigned lineTokens = options.lineTokens ? options.lineTokens : 1;
+
+    while (corpus.text.size() < options.bytes) {
+        size_t pick = rng.below(total);
+        int kind = 0;
+        while (pick >= weights[kind]) {
+            pick -= weights[kind++];
+        }
+
+        switch (kind) {
+            case 0: {
+                // 与关键字重名时仍是合法 token，只是类别不同，不影响计数
+                size_t len = 1 + rng.below(12);
+                corpus.text += IDENT_HEAD[rng.below(sizeof(IDENT_HEAD) - 1)];
+                for (size_t i = 1; i < len; ++i) {
+                    corpus.text += IDENT_TAIL[rng.below(sizeof(IDENT_TAIL) - 1)];
+                }
+                break;
+            }
+            case 1: {
+                size_t len = 1 + rng.below(9);
+                for (size_t i = 0; i < len; ++i) {
+                    corpus.text += (char)('0' + rng.below(10));
+                }
+                break;
+            }
+            case 2:
+                corpus.text += keywords[rng.below(keywords.size())];
+                break;
+            default: {
+                size_t pick = rng.below(symbolCount);
+                if (pick < symbols.size()) {
+                    corpus.text += symbols[pick];
+                    break;
+                }
+
+                const PatternSampler& p = patterns[pick - symbols.size()];
+                int state = table.start;
+                for (size_t len = 0; ; ++len) {
+                    // 可停下时以 1/4 的概率结束；过长后尽快结束
+                    if (p.dist[state] == 0 &&
+                        (len >= MAX_PATTERN_LEN || rng.below(4) == 0)) {
+                        break;
+                    }
+
+                    std::pair<char, int> choice[95];
+                    size_t n = 0;
+                    for (const auto& m : moves[state]) {
+                        int d = p.dist[m.second];
+                        if (d >= 0 && (len < MAX_PATTERN_LEN || d < p.dist[state])) {
+                            choice[n++] = m;
+                        }
+                    }
+                    if (n == 0) break;    // 只可能发生在可停下的状态
+
+                    const auto& m = choice[rng.below(n)];
+                    corpus.text += m.first;
+                    state = m.second;
+                }
+                break;
+            }
+        }
+        corpus.tokens++;
+
+        // 分隔符：大多为空格，平均每 lineTokens 个 token 换一次行
+        if (rng.below(lineTokens) == 0) {
+            corpus.text += '\n';
+            for (size_t i = rng.below(3); i > 0; --i) corpus.text += "    ";
+        } else {
+            corpus.text += rng.below(8) == 0 ? '\t' : ' ';
+        }
+    }
+
+    return corpus;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include "lexer_rule.h"
+#include "dfa_table.h"
+
+/*
+ * 合成语料生成器
+ * ==============
+ * 按规则集随机拼出一份源代码，供基准测试扫描
+ *
+ * - 四类 token 按权重抽取：
+ *     ident   —— {ID}（字母 / 下划线开头，长度 1~12）
+ *     number  —— {NUM}（1~9 位数字）
+ *     keyword —— 形如标识符的字面量规则（if / while ...）
+ *     symbol  —— 其余字面量规则（运算符、界符），以及正则规则：
+ *              在 table 上随机游走到接受该 Token 的状态得到样本；
+ *              抽不出独立样本的正则规则跳过并在 stderr 上警告
+ *   规则集中没有的类别自动跳过
+ * - token 之间总有空白，保证扫描结果与生成序列一一对应
+ * - 伪随机数由 seed 决定（自带 splitmix64，不依赖标准库实现），
+ *   同一规则集 + 同一参数在任何平台上生成完全相同的文本
+ */
+struct CorpusMix {
+    unsigned ident = 40;
+    unsigned number = 20;
+    unsigned keyword = 15;
+    unsigned symbol = 25;
+};
+
+struct CorpusOptions {
+    size_t bytes = 16u << 20;     // 目标大小（达到后停止，略有超出）
+    uint64_t seed = 1;            // 随机种子
+    CorpusMix mix;                // token 类别权重
+    unsigned lineTokens = 12;     // 平均每行 token 数
+};
+
+struct Corpus {
+    std::string text;             // 生成的源代码
+    size_t tokens = 0;            // 其中的 token 数（不含 ENDFILE）
+};
+
+// 按规则集生成语料；table 为该规则集的转移表（用于正则规则抽样）
+// 规则集中一类 token 都抽不到时抛出异常
+Corpus generateCorpus(const RuleSet& rules, const DFATable& table,
+                      const CorpusOptions& options);
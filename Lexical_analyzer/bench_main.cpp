@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "token.h"
+#include "lexer.h"
+#include "lexer_generator.h"
+#include "lexer_rule_parser.h"
+#include "dfa_table.h"
+#include "corpus_generator.h"
+
+/*
+ * 词法分析器吞吐量基准
+ * ====================
+ * 对每个规则集生成可复现的合成语料，在上面反复运行 Lexer，报告
+ * MB/s、token/s 以及每个 token 的堆分配次数
+ *
+ * 用法：lexer_bench [rule_file...] [--size=MB] [--seed=N]
+ *                   [--reps=N] [--warmup=N] [--mix=I,N,K,S]
+ *                   [--keyword-hash] [--construction=thompson|followpos]
+ *                   [--lazy[=KB]] [--save=DIR]
+ *
+ * - 不给规则文件时依次测 rules/ 下自带的三个规则集
+ * - --mix：ident / number / keyword / symbol 四类 token 的权重
+ * - --lazy：另测一行按需 DFA（批量取 token），并报告其启动耗时与缓存情况
+ * - --save：把语料写到 DIR/<规则名>.txt，便于用 lexer_gen 复现
+ * - 每次运行都核对 token 数与生成时一致，出现 ERROR 或数目不符即失败退出
+ */
+
+// ===== 堆分配计数 =====
+// 替换全局 operator new，计数只在被测区间前后各读一次
+static std::atomic<size_t> allocations{0};
+
+// operator new 本身就改用 malloc，GCC 对 free 的配对检查在这里是误报
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct Options {
+    std::vector<std::string> rules;
+    size_t megabytes = 16;
+    uint64_t seed = 1;
+    int reps = 5;
+    int warmup = 1;
+    CorpusMix mix;
+    bool keywordHash = false;
+    DFAConstruction construction = DFAConstruction::THOMPSON;
+    bool lazy = false;
+    size_t lazyBudget = LazyDFA::DEFAULT_BUDGET;
+    std::string saveDir;
+};
+
+// 一次扫描的结果
+struct RunResult {
+    double seconds = 0;
+    size_t tokens = 0;
+    size_t allocs = 0;
+    bool error = false;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// 三种取 token 的方式：批量（结构数组）/ 逐个视图 / 逐个拷贝
+enum class Mode { BATCH, VIEW, TOKEN };
+
+const char* modeName(Mode m) {
+    switch (m) {
+        case Mode::BATCH: return "batch";
+        case Mode::VIEW:  return "view";
+        default:          return "token";
+    }
+}
+
+// engine：DFATable（转移表）或 LazyDFA（按需构造）
+template <typename Engine>
+RunResult runOnce(Mode mode, std::string_view src, Engine& engine) {
+    RunResult r;
+    size_t allocBefore = allocations.load(std::memory_order_relaxed);
+    Clock::time_point begin = Clock::now();
+
+    Lexer lexer(src, engine);
+    switch (mode) {
+        case Mode::BATCH: {
+            TokenBatch batch;
+            bool done = false;
+            while (!done) {
+                lexer.nextTokens(batch);
+                for (size_t i = 0; i < batch.count; ++i) {
+                    if (batch.type[i] == TokenType::ENDFILE) {
+                        done = true;
+                    } else if (batch.type[i] == TokenType::ERROR) {
+                        r.error = done = true;
+                    } else {
+                        r.tokens++;
+                    }
+                }
+            }
+            break;
+        }
+        case Mode::VIEW:
+            while (true) {
+                TokenView tok = lexer.nextTokenView();
+                if (tok.type == TokenType::ENDFILE) break;
+                if (tok.type == TokenType::ERROR) { r.error = true; break; }
+                r.tokens++;
+            }
+            break;
+        case Mode::TOKEN:
+            while (true) {
+                Token tok = lexer.nextToken();
+                if (tok.type == TokenType::ENDFILE) break;
+                if (tok.type == TokenType::ERROR) { r.error = true; break; }
+                r.tokens++;
+            }
+            break;
+    }
+
+    r.seconds = std::chrono::duration<double>(Clock::now() - begin).count();
+    r.allocs = allocations.load(std::memory_order_relaxed) - allocBefore;
+    return r;
+}
+
+// 测一个规则集；核对失败返回 false
+bool benchRuleSet(const std::string& ruleFile, const Options& opt) {
+    // ===== 构造转移表（不走缓存，顺带报告生成耗时）=====
+    Clock::time_point begin = Clock::now();
+    LexerGenerator gen;
+    gen.loadRuleFile(ruleFile);
+    gen.setKeywordHash(opt.keywordHash);
+    gen.setConstruction(opt.construction);
+    DFATable table = gen.buildTable();
+    double buildMs =
+        std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+    // ===== 生成语料 =====
+    CorpusOptions corpusOpt;
+    corpusOpt.bytes = opt.megabytes << 20;
+    corpusOpt.seed = opt.seed;
+    corpusOpt.mix = opt.mix;
+    Corpus corpus = generateCorpus(LexerRuleParser::parseFromFile(ruleFile),
+                                   table, corpusOpt);
+
+    if (!opt.saveDir.empty()) {
+        std::string name = ruleFile.substr(ruleFile.find_last_of("/\\") + 1);
+        name = name.substr(0, name.rfind('.')) + ".txt";
+        std::ofstream ofs(opt.saveDir + "/" + name, std::ios::binary);
+        if (!ofs) {
+            throw std::runtime_error("Cannot open file: " + opt.saveDir + "/" + name);
+        }
+        ofs << corpus.text;
+    }
+
+    double mb = corpus.text.size() / (1024.0 * 1024.0);
+    std::printf("%s: %.1f MB, %zu tokens, table %d states x %d classes "
+                "(built in %.1f ms)\n",
+                ruleFile.c_str(), mb, corpus.tokens,
+                table.numStates, table.numClasses, buildMs);
+    std::printf("  %-6s %12s %12s %12s %14s\n",
+                "mode", "MB/s (med)", "MB/s (best)", "Mtok/s (med)", "allocs/token");
+
+    // 预热后测 reps 次并打印一行；核对失败返回 false
+    auto measure = [&](const char* name, auto run) {
+        for (int i = 0; i < opt.warmup; ++i) {
+            run();
+        }
+
+        std::vector<double> seconds;
+        size_t allocs = 0;
+        for (int i = 0; i < opt.reps; ++i) {
+            RunResult r = run();
+            if (r.error || r.tokens != corpus.tokens) {
+                std::printf("  %-6s FAILED: %s (%zu of %zu tokens)\n",
+                            name,
+                            r.error ? "lexical error" : "token count mismatch",
+                            r.tokens, corpus.tokens);
+                return false;
+            }
+            seconds.push_back(r.seconds);
+            allocs = r.allocs;
+        }
+
+        std::sort(seconds.begin(), seconds.end());
+        double median = seconds[seconds.size() / 2];
+        double best = seconds.front();
+
+        std::printf("  %-6s %12.1f %12.1f %12.2f %14.4f\n",
+                    name, mb / median, mb / best,
+                    corpus.tokens / median / 1e6,
+                    (double)allocs / corpus.tokens);
+        return true;
+    };
+
+    bool ok = true;
+    for (Mode mode : {Mode::BATCH, Mode::VIEW, Mode::TOKEN}) {
+        ok = measure(modeName(mode), [&] {
+            return runOnce(mode, corpus.text, table);
+        }) && ok;
+    }
+
+    // ===== 按需 DFA =====
+    // 缓存在各次运行间保留，预热后测的是稳定状态；启动耗时单独报告
+    if (opt.lazy) {
+        begin = Clock::now();
+        LazyDFA lazy = gen.buildLazyDFA(opt.lazyBudget);
+        double lazyMs =
+            std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+
+        ok = measure("lazy", [&] {
+            return runOnce(Mode::BATCH, corpus.text, lazy);
+        }) && ok;
+
+        std::printf("  lazy: built in %.1f ms, %zu states cached "
+                    "(%.1f KB of %zu KB), %zu flushes\n",
+                    lazyMs, lazy.stateCount(), lazy.memoryUsed() / 1024.0,
+                    opt.lazyBudget >> 10, lazy.flushCount());
+    }
+    std::printf("\n");
+    return ok;
+}
+
+Options parseOptions(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--size=", 0) == 0) {
+            opt.megabytes = std::stoul(arg.substr(7));
+        } else if (arg.rfind("--seed=", 0) == 0) {
+            opt.seed = std::stoull(arg.substr(7));
+        } else if (arg.rfind("--reps=", 0) == 0) {
+            opt.reps = std::max(1, std::stoi(arg.substr(7)));
+        } else if (arg.rfind("--warmup=", 0) == 0) {
+            opt.warmup = std::max(0, std::stoi(arg.substr(9)));
+        } else if (arg.rfind("--mix=", 0) == 0) {
+            unsigned w[4];
+            if (std::sscanf(arg.c_str() + 6, "%u,%u,%u,%u",
+                            &w[0], &w[1], &w[2], &w[3]) != 4) {
+                throw std::runtime_error("--mix expects I,N,K,S: " + arg);
+            }
+            opt.mix = CorpusMix{w[0], w[1], w[2], w[3]};
+        } else if (arg == "--keyword-hash") {
+            opt.keywordHash = true;
+        } else if (arg == "--construction=thompson") {
+            opt.construction = DFAConstruction::THOMPSON;
+        } else if (arg == "--construction=followpos") {
+            opt.construction = DFAConstruction::FOLLOWPOS;
+        } else if (arg == "--lazy") {
+            opt.lazy = true;
+        } else if (arg.rfind("--lazy=", 0) == 0) {
+            opt.lazy = true;
+            opt.lazyBudget = (size_t)std::stoul(arg.substr(7)) << 10;
+        } else if (arg.rfind("--save=", 0) == 0) {
+            opt.saveDir = arg.substr(7);
+        } else if (arg.rfind("--", 0) == 0) {
+            throw std::runtime_error("Unknown option: " + arg);
+        } else {
+            opt.rules.push_back(arg);
+        }
+    }
+
+    if (opt.rules.empty()) {
+        opt.rules = {"rules/c_like.lex", "rules/tiny.lex", "rules/expr.lex"};
+    }
+    return opt;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        Options opt = parseOptions(argc, argv);
+
+        bool ok = true;
+        for (const auto& rule : opt.rules) {
+            ok = benchRuleSet(rule, opt) && ok;
+        }
+        return ok ? 0 : 1;
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "Fatal Error: %s\n", e.what());
+        return 1;
+    }
+}
@@ -0,0 +1,285 @@
+#include "dfa_cache.h"
+#include "source_file.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr char MAGIC[8] = {'L', 'X', 'D', 'F', 'A', 'C', 'H', 'E'};
+
+/*
+ * 文件头
+ */
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t start;
+    int32_t numStates;
+    int32_t numClasses;
+};
+
+/*
+ * 顺序读取，越界即视为损坏
+ */
+struct Reader {
+    const char* p;
+    const char* end;
+
+    bool read(void* dst, size_t n) {
+        if ((size_t)(end - p) < n) return false;
+        std::memcpy(dst, p, n);
+        p += n;
+        return true;
+    }
+};
+
+/*
+ * FNV-1a 64 位
+ */
+uint64_t fnv1a(const char* p, size_t n, uint64_t h) {
+    for (size_t i = 0; i < n; ++i) {
+        h ^= (unsigned char)p[i];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+}
+
+std::string dfaCacheKey(const std::string& ruleFile,
+                        const std::string& options) {
+    SourceFile rules(ruleFile);
+    std::string_view text = rules.view();
+
+    uint64_t h = 0xcbf29ce484222325ULL;
+    h = fnv1a((const char*)&DFA_CACHE_VERSION, sizeof(DFA_CACHE_VERSION), h);
+    h = fnv1a(options.data(), options.size() + 1, h);
+    h = fnv1a(text.data(), text.size(), h);
+
+    static const char hex[] = "0123456789abcdef";
+    std::string key(16, '0');
+    for (int i = 15; i >= 0; --i, h >>= 4) {
+        key[i] = hex[h & 0xF];
+    }
+    return key;
+}
+
+bool loadDFATable(const std::string& path, DFATable& table) {
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        return false;
+    }
+
+    // 缓存文件只读映射
+    SourceFile file(path);
+    std::string_view bytes = file.view();
+    Reader in{bytes.data(), bytes.data() + bytes.size()};
+
+    // ===== 文件头 =====
+    CacheHeader h;
+    if (!in.read(&h, sizeof(h)) ||
+        std::memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        h.version != DFA_CACHE_VERSION ||
+        h.numStates < 0 || h.numClasses < 1 || h.numClasses > 256 ||
+        h.start < DFATable::DEAD || h.start >= h.numStates) {
+        return false;
+    }
+
+    DFATable t;
+    t.start = h.start;
+    t.numStates = h.numStates;
+    t.numClasses = h.numClasses;
+
+    const size_t states = (size_t)h.numStates;
+    t.next.resize(states * (size_t)h.numClasses);
+    t.accept.resize(states);
+    std::vector<int32_t> tokens(states);
+    t.selfLoop.resize(states);
+
+    // ===== 各表 =====
+    if (!in.read(t.byteClass.data(), t.byteClass.size()) ||
+        !in.read(t.next.data(), t.next.size() * sizeof(int)) ||
+        !in.read(t.accept.data(), states) ||
+        !in.read(tokens.data(), states * sizeof(int32_t))) {
+        return false;
+    }
+
+    for (auto& r : t.selfLoop) {
+        unsigned char count = 0;
+        if (!in.read(&count, 1) || count > ByteRanges::MAX ||
+            !in.read(r.lo, ByteRanges::MAX) ||
+            !in.read(r.hi, ByteRanges::MAX)) {
+            return false;
+        }
+        r.count = count;
+    }
+
+    // ===== 关键字表 =====
+    int32_t idToken = 0;
+    uint32_t numSeeds = 0, numWords = 0;
+    if (!in.read(&idToken, sizeof(idToken)) ||
+        !in.read(&numSeeds, sizeof(numSeeds)) ||
+        !in.read(&numWords, sizeof(numWords)) ||
+        (numSeeds == 0) != (numWords == 0) ||
+        numSeeds > (size_t)(in.end - in.p) ||
+        numWords > (size_t)(in.end - in.p)) {
+        return false;
+    }
+
+    KeywordTable& kw = t.keywords;
+    std::vector<int32_t> kwTokens;
+    kw.seeds.resize(numSeeds);
+    if (!in.read(kw.seeds.data(), numSeeds * sizeof(uint32_t))) {
+        return false;
+    }
+    for (uint32_t k = 0; k < numWords; ++k) {
+        uint32_t len = 0;
+        int32_t token = 0;
+        if (!in.read(&len, sizeof(len)) || len > (size_t)(in.end - in.p)) {
+            return false;
+        }
+        std::string word(len, '\0');
+        if (!in.read(word.data(), len) || !in.read(&token, sizeof(token))) {
+            return false;
+        }
+        kw.words.push_back(std::move(word));
+        kwTokens.push_back(token);
+    }
+
+    // ===== Token 种类表 =====
+    uint32_t numKinds = 0;
+    if (!in.read(&numKinds, sizeof(numKinds)) || numKinds < 2 ||
+        numKinds > (size_t)(in.end - in.p)) {
+        return false;
+    }
+    t.kinds.names.clear();
+    t.kinds.literals.clear();
+    for (uint32_t k = 0; k < numKinds; ++k) {
+        std::string strings[2];
+        for (auto& str : strings) {
+            uint32_t len = 0;
+            if (!in.read(&len, sizeof(len)) || len > (size_t)(in.end - in.p)) {
+                return false;
+            }
+            str.resize(len);
+            if (!in.read(str.data(), len)) {
+                return false;
+            }
+        }
+        t.kinds.names.push_back(std::move(strings[0]));
+        t.kinds.literals.push_back(std::move(strings[1]));
+    }
+
+    if (in.p != in.end) {
+        return false;
+    }
+
+    // ===== 取值校验：坏文件不能让 Lexer 越界 =====
+    for (unsigned char c : t.byteClass) {
+        if (c >= t.numClasses) return false;
+    }
+    for (int to : t.next) {
+        if (to < DFATable::DEAD || to >= t.numStates) return false;
+    }
+
+    auto validToken = [&](int32_t tok) {
+        return tok >= 0 && (uint32_t)tok < numKinds;
+    };
+
+    t.acceptToken.resize(states);
+    for (size_t i = 0; i < states; ++i) {
+        if (!validToken(tokens[i])) return false;
+        t.acceptToken[i] = (TokenType)tokens[i];
+    }
+    if (!validToken(idToken)) return false;
+    kw.idToken = (TokenType)idToken;
+    for (int32_t tok : kwTokens) {
+        if (!validToken(tok)) return false;
+        kw.tokens.push_back((TokenType)tok);
+    }
+
+    table = std::move(t);
+    return true;
+}
+
+void saveDFATable(const std::string& path, const DFATable& table) {
+    CacheHeader h;
+    std::memcpy(h.magic, MAGIC, sizeof(MAGIC));
+    h.version = DFA_CACHE_VERSION;
+    h.start = table.start;
+    h.numStates = table.numStates;
+    h.numClasses = table.numClasses;
+
+    std::vector<int32_t> tokens(table.acceptToken.size());
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        tokens[i] = (int32_t)table.acceptToken[i];
+    }
+
+    // 临时文件名带随机后缀，多个进程同时写互不干扰
+    std::string tmp = path + ".tmp" + std::to_string(std::random_device{}());
+
+    // 写入或改名失败时删掉临时文件，否则每次失败都在缓存目录里留下一个
+    try {
+        std::ofstream out(tmp, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Cannot open file: " + tmp);
+        }
+
+        out.write((const char*)&h, sizeof(h));
+        out.write((const char*)table.byteClass.data(), table.byteClass.size());
+        out.write((const char*)table.next.data(),
+                  table.next.size() * sizeof(int));
+        out.write((const char*)table.accept.data(), table.accept.size());
+        out.write((const char*)tokens.data(), tokens.size() * sizeof(int32_t));
+
+        for (auto& r : table.selfLoop) {
+            unsigned char count = (unsigned char)r.count;
+            out.write((const char*)&count, 1);
+            out.write((const char*)r.lo, ByteRanges::MAX);
+            out.write((const char*)r.hi, ByteRanges::MAX);
+        }
+
+        const KeywordTable& kw = table.keywords;
+        int32_t idToken = (int32_t)kw.idToken;
+        uint32_t numSeeds = (uint32_t)kw.seeds.size();
+        uint32_t numWords = (uint32_t)kw.words.size();
+        out.write((const char*)&idToken, sizeof(idToken));
+        out.write((const char*)&numSeeds, sizeof(numSeeds));
+        out.write((const char*)&numWords, sizeof(numWords));
+        out.write((const char*)kw.seeds.data(), numSeeds * sizeof(uint32_t));
+        for (uint32_t k = 0; k < numWords; ++k) {
+            uint32_t len = (uint32_t)kw.words[k].size();
+            int32_t token = (int32_t)kw.tokens[k];
+            out.write((const char*)&len, sizeof(len));
+            out.write(kw.words[k].data(), len);
+            out.write((const char*)&token, sizeof(token));
+        }
+
+        uint32_t numKinds = (uint32_t)table.kinds.size();
+        out.write((const char*)&numKinds, sizeof(numKinds));
+        for (uint32_t k = 0; k < numKinds; ++k) {
+            for (const std::string* str : {&table.kinds.names[k],
+                                           &table.kinds.literals[k]}) {
+                uint32_t len = (uint32_t)str->size();
+                out.write((const char*)&len, sizeof(len));
+                out.write(str->data(), len);
+            }
+        }
+
+        out.close();
+        if (!out) {
+            throw std::runtime_error("Cannot write file: " + tmp);
+        }
+
+        std::filesystem::rename(tmp, path);
+    }
+    catch (...) {
+        std::error_code ec;
+        std::filesystem::remove(tmp, ec);
+        throw;
+    }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include "dfa_table.h"
+
+/*
+ * DFA 磁盘缓存
+ * ============
+ * 将最小化 DFA 的转移表序列化到缓存目录，
+ * 同一份规则文件再次运行时直接映射读入，跳过 解析 → NFA → DFA → 最小化
+ *
+ * - 键：规则文件内容 + 生成选项 + 生成器版本的 FNV-1a 64 位散列
+ * - 文件：<cacheDir>/<键>.dfa
+ * - 格式：文件头（魔数 / 版本 / 尺寸）+ 各表按本机字节序顺序排列
+ *         + 关键字完美散列表（未启用时为空）+ Token 种类表（名称 / 字面量）
+ *
+ * 缓存只在本机使用；魔数、版本或尺寸对不上时视为未命中并重新生成
+ */
+
+// 生成器版本：转移表语义或文件格式变化时递增，旧缓存自动失效
+constexpr uint32_t DFA_CACHE_VERSION = 4;
+
+// 计算规则文件的缓存键（16 位十六进制串）
+// options: 影响生成结果的选项（如关键字完美散列），不同选项各自缓存
+std::string dfaCacheKey(const std::string& ruleFile,
+                        const std::string& options = "");
+
+// 读入缓存文件；不存在或已损坏时返回 false
+bool loadDFATable(const std::string& path, DFATable& table);
+
+// 写出缓存文件（先写临时文件再改名，并发运行时不会读到半个文件）
+void saveDFATable(const std::string& path, const DFATable& table);
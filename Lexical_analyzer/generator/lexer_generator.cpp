@@ -1,31 +1,301 @@
 #include "lexer_generator.h"
 
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <set>
 #include <stdexcept>
 
 #include "lexer_rule.h"
 #include "lexer_rule_parser.h"
 #include "thompson.h"
+#include "followpos.h"
 #include "dfa.h"
 #include "dfa_min.h"
+#include "byte_class.h"
+#include "dfa_cache.h"
+#include "charset.h"
 
 void LexerGenerator::loadRuleFile(const std::string& filename) {
     ruleFile = filename;
 }
 
-DFA LexerGenerator::buildDFA() {
+/*
+ * nfaMatches
+ * ==========
+ * 单条规则的 NFA 是否完整匹配 s（逐字节推进 ε-闭包）
+ */
+static std::vector<State*> closure(std::vector<State*> work) {
+    std::set<State*> seen;
+    std::vector<State*> out;
+    while (!work.empty()) {
+        State* s = work.back();
+        work.pop_back();
+        if (!seen.insert(s).second) continue;
+        out.push_back(s);
+        work.insert(work.end(), s->eps.begin(), s->eps.end());
+    }
+    return out;
+}
+
+static bool nfaMatches(const NFA& nfa, const std::string& s) {
+    std::vector<State*> cur = closure({nfa.start});
+    for (char c : s) {
+        std::vector<State*> next;
+        for (State* st : cur) {
+            auto it = st->trans.find(c);
+            if (it != st->trans.end()) {
+                next.insert(next.end(), it->second.begin(), it->second.end());
+            }
+            for (auto& edge : st->sets) {
+                if (edge.first.contains((unsigned char)c)) next.push_back(edge.second);
+            }
+        }
+        if (next.empty()) return false;
+        cur = closure(std::move(next));
+    }
+    return std::find(cur.begin(), cur.end(), nfa.accept) != cur.end();
+}
+
+// 每条规则单独的 NFA，下标与 rules.rules 一致（结点分配在 ctx 中）
+static std::vector<NFA> buildRuleNFAs(AutomatonContext& ctx, const RuleSet& rules) {
+    std::vector<NFA> nfas;
+    for (auto& spec : buildRegexSpecs(ctx, rules)) {
+        nfas.push_back(buildNFA(ctx, spec.second));
+    }
+    return nfas;
+}
+
+/*
+ * warnShadowedLiterals
+ * ====================
+ * 字面量规则只能匹配它自己；若优先级更高（在规则文件中更早出现）的规则
+ * 也完整匹配这个字面量，它就永远不会产生，在 stderr 上提示
+ * （如写在 {ID} 之后的关键字会被当作 ID）
+ */
+static void warnShadowedLiterals(const RuleSet& rules) {
+    AutomatonContext scratch;
+    std::vector<NFA> nfas = buildRuleNFAs(scratch, rules);
+
+    const size_t n = rules.rules.size();
+    for (size_t i = 0; i < n; ++i) {
+        const LexerRule& rule = rules.rules[i];
+        if (rule.regex || rule.pattern == "{ID}" || rule.pattern == "{NUM}") {
+            continue;
+        }
+
+        size_t winner = n;
+        for (size_t j = 0; j < n; ++j) {
+            const LexerRule& other = rules.rules[j];
+            if (tokenPriority(other.type) < tokenPriority(rule.type) &&
+                (winner == n || tokenPriority(other.type) <
+                                    tokenPriority(rules.rules[winner].type)) &&
+                nfaMatches(nfas[j], rule.pattern)) {
+                winner = j;
+            }
+        }
+        if (winner != n) {
+            std::cerr << "Warning: rule " << rules.kinds.name(rule.type) << " '"
+                      << rule.pattern << "' is never matched: it lexes as "
+                      << rules.kinds.name(rules.rules[winner].type)
+                      << ", which comes earlier in the rule file\n";
+        }
+    }
+}
+
+/*
+ * extractKeywords
+ * ===============
+ * 从规则中取出可由 ID 匹配、且优先级高于 ID 的字面量规则
+ * 这些规则在自动机里只会与 ID 打平再靠 tokenPriority 取胜，
+ * 改为匹配成 ID 后查表，结果相同
+ *
+ * - ID 规则为 {ID}，或形如标识符的正则（接受 a、_、a0 等，拒绝数字开头）
+ * - 优先级介于关键字与 ID 之间、又能匹配该关键字的规则（如 /f[a-z]+/）
+ *   在关键字移出后会胜过 ID，这样的关键字留在自动机里
+ */
+static KeywordTable extractKeywords(RuleSet& rules) {
+    AutomatonContext scratch;
+    std::vector<NFA> nfas = buildRuleNFAs(scratch, rules);
+
+    // 粗略判断正则是否描述标识符：接受几个典型标识符、拒绝数字开头
+    auto isIdentifierRegex = [&](size_t i) {
+        for (const char* probe : {"a", "Z", "_", "a0", "_x9Y"}) {
+            if (!nfaMatches(nfas[i], probe)) return false;
+        }
+        return !nfaMatches(nfas[i], "0");
+    };
+
+    const size_t n = rules.rules.size();
+    size_t idIndex = n;
+    for (size_t i = 0; i < n && idIndex == n; ++i) {
+        const LexerRule& rule = rules.rules[i];
+        if (rule.regex ? isIdentifierRegex(i) : rule.pattern == "{ID}") {
+            idIndex = i;
+        }
+    }
+    if (idIndex == n) {
+        // 没有形如标识符的字面量时本就无事可做，不必提示
+        auto identifierLike = [](const LexerRule& rule) {
+            const std::string& s = rule.pattern;
+            return !rule.regex && !s.empty() && !isDigit((unsigned char)s[0]) &&
+                   std::all_of(s.begin(), s.end(),
+                               [](unsigned char c) { return isIdentChar(c); });
+        };
+        if (std::any_of(rules.rules.begin(), rules.rules.end(), identifierLike)) {
+            std::cerr << "Warning: --keyword-hash ignored: no identifier rule "
+                         "({ID} or a regex such as /[a-zA-Z_]\\w*/)\n";
+        }
+        return KeywordTable();
+    }
+    TokenType idToken = rules.rules[idIndex].type;
+    int idPriority = tokenPriority(idToken);
+
+    auto isKeyword = [&](size_t i) {
+        const LexerRule& rule = rules.rules[i];
+        int priority = tokenPriority(rule.type);
+        if (rule.regex || rule.pattern == "{ID}" || rule.pattern == "{NUM}" ||
+            priority >= idPriority || !nfaMatches(nfas[idIndex], rule.pattern)) {
+            return false;
+        }
+        for (size_t j = 0; j < n; ++j) {
+            int other = tokenPriority(rules.rules[j].type);
+            if (j != i && other > priority && other < idPriority &&
+                nfaMatches(nfas[j], rule.pattern)) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    std::vector<std::pair<std::string, TokenType>> keywords;
+    std::vector<LexerRule> kept;
+
+    for (size_t i = 0; i < n; ++i) {
+        const LexerRule& rule = rules.rules[i];
+        if (!isKeyword(i)) {
+            kept.push_back(rule);
+            continue;
+        }
+
+        // 同一字面量出现多次时保留优先级最高（其次最先出现）的一条，与 DFA 一致
+        auto it = std::find_if(keywords.begin(), keywords.end(),
+                               [&](auto& kw) { return kw.first == rule.pattern; });
+        if (it == keywords.end()) {
+            keywords.push_back({rule.pattern, rule.type});
+        } else if (tokenPriority(rule.type) < tokenPriority(it->second)) {
+            it->second = rule.type;
+        }
+    }
+
+    rules.rules = std::move(kept);
+    return buildKeywordTable(keywords, idToken);
+}
+
+DFA LexerGenerator::buildDFA(AutomatonContext& ctx) {
     if (ruleFile.empty()) {
         throw std::runtime_error("Lexer rule file not set");
     }
 
     // 1. 解析 .lex 规则
     RuleSet rules = LexerRuleParser::parseFromFile(ruleFile);
+    warnShadowedLiterals(rules);
+
+    // 1'. 关键字移出自动机
+    KeywordTable keywords;
+    if (keywordHash) {
+        keywords = extractKeywords(rules);
+    }
+
+    // 2~4 的中间结果放在临时上下文里，最小化之后整体释放
+    AutomatonContext scratch;
+
+    // 2. 规则 → 正则 AST
+    auto specs = buildRegexSpecs(scratch, rules);
+
+    DFA dfa;
+    if (construction == DFAConstruction::FOLLOWPOS) {
+        // 3. 由 AST 的字符叶结点计算字节等价类
+        std::vector<RegexNode*> roots;
+        for (auto& spec : specs) roots.push_back(spec.second);
+        ByteClasses classes = computeByteClasses(roots);
+
+        // 4. AST → DFA（followpos，不建 NFA）
+        dfa = buildDFAFollowpos(scratch, specs, classes);
+    } else {
+        // 3. AST → NFA，计算所有规则共享的字节等价类
+        State* nfaStart = buildMasterNFA(scratch, specs);
+        ByteClasses classes = computeByteClasses(nfaStart);
+
+        // 4. NFA → DFA（以等价类为字母表）
+        dfa = ::buildDFA(scratch, nfaStart, classes);
+    }
+
+    // 5. DFA 最小化（结果分配在调用方的上下文中）
+    DFA minDFA = minimizeDFA(ctx, dfa);
+    minDFA.keywords = std::move(keywords);
+    minDFA.kinds = std::move(rules.kinds);
+    return minDFA;
+}
+
+LazyDFA LexerGenerator::buildLazyDFA(size_t budget) {
+    if (ruleFile.empty()) {
+        throw std::runtime_error("Lexer rule file not set");
+    }
+
+    RuleSet rules = LexerRuleParser::parseFromFile(ruleFile);
+    warnShadowedLiterals(rules);
+
+    KeywordTable keywords;
+    if (keywordHash) {
+        keywords = extractKeywords(rules);
+    }
+
+    // AST 只在构造位置自动机时使用
+    AutomatonContext scratch;
+    auto specs = buildRegexSpecs(scratch, rules);
 
-    // 2. 规则 → NFA
-    State* nfaStart = buildNFAFromRules(rules);
+    std::vector<RegexNode*> roots;
+    for (auto& spec : specs) roots.push_back(spec.second);
+    ByteClasses classes = computeByteClasses(roots);
 
-    // 3. NFA → DFA
-    DFA dfa = ::buildDFA(nfaStart);
+    return LazyDFA(buildPositionAutomaton(specs, classes), classes,
+                   std::move(keywords), std::move(rules.kinds), budget);
+}
+
+DFATable LexerGenerator::buildTable(const std::string& cacheDir) {
+    if (cacheDir.empty()) {
+        AutomatonContext ctx;
+        return buildDFATable(buildDFA(ctx));
+    }
+
+    if (ruleFile.empty()) {
+        throw std::runtime_error("Lexer rule file not set");
+    }
+
+    // 1. 命中：直接读入
+    std::string path = cacheDir + "/" +
+                       dfaCacheKey(ruleFile, keywordHash ? "kwhash" : "") +
+                       ".dfa";
+
+    DFATable table;
+    if (loadDFATable(path, table)) {
+        return table;
+    }
+
+    // 2. 未命中：完整生成
+    {
+        AutomatonContext ctx;
+        table = buildDFATable(buildDFA(ctx));
+    }
+
+    // 3. 写回；缓存目录不可写时只影响下次速度，不影响本次结果
+    try {
+        std::filesystem::create_directories(cacheDir);
+        saveDFATable(path, table);
+    }
+    catch (const std::exception&) {
+    }
 
-    // 4. DFA 最小化
-    return minimizeDFA(dfa);
+    return table;
 }
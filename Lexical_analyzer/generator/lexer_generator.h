@@ -2,6 +2,21 @@
 
 #include <string>
 #include "dfa.h"
+#include "dfa_table.h"
+#include "automaton_context.h"
+#include "lazy_dfa.h"
+
+/*
+ * DFAConstruction
+ * ===============
+ * 由正则构造（未最小化）DFA 的方式；两者最小化后的结果完全相同
+ * - THOMPSON：正则 → Thompson NFA → 子集构造
+ * - FOLLOWPOS：正则 → followpos 直接构造，不建 NFA，中间结构更小
+ */
+enum class DFAConstruction {
+    THOMPSON,
+    FOLLOWPOS
+};
 
 /*
  * LexerGenerator
@@ -11,15 +26,39 @@
  * 职责：
  * - 读取 .lex 规则文件
  * - 基于规则构造 DFA
+ * - 可选：按规则文件内容缓存最小化后的转移表
+ * - 可选：关键字移出自动机，改用完美散列归类
+ *
+ * 生成器本身不持有任何自动机结点，可以在同一进程内反复使用
  */
 class LexerGenerator {
 public:
     // 读取规则文件
     void loadRuleFile(const std::string& filename);
 
+    // 关键字完美散列模式：形如标识符的字面量规则不进入 NFA，
+    // 先按 {ID} 匹配，再由 DFA::keywords 归类
+    void setKeywordHash(bool enable) { keywordHash = enable; }
+
+    // 选择 DFA 构造方式（默认 Thompson）
+    void setConstruction(DFAConstruction c) { construction = c; }
+
     // 构造 DFA（正则 → NFA → DFA → 最小化）
-    DFA buildDFA();
+    // 被更早的规则完全遮蔽的字面量规则（永远不会产生）在 stderr 上警告
+    // 最小化 DFA 的状态分配在 ctx 中；中间的 AST / NFA / 未最小化 DFA
+    // 在返回前即已释放
+    DFA buildDFA(AutomatonContext& ctx);
+
+    // 构造按需 DFA：只建位置自动机，DFA 状态在扫描时按需计算
+    // budget：状态缓存的内存预算（字节）
+    LazyDFA buildLazyDFA(size_t budget = LazyDFA::DEFAULT_BUDGET);
+
+    // 构造转移表；cacheDir 非空时先查磁盘缓存，未命中再生成并写回
+    // 构造过程中的全部结点在返回前释放
+    DFATable buildTable(const std::string& cacheDir = "");
 
 private:
     std::string ruleFile;
+    bool keywordHash = false;
+    DFAConstruction construction = DFAConstruction::THOMPSON;
 };
@@ -10,14 +10,16 @@
  */
 struct LexerRule {
     TokenType type;        // Token 类型
-    std::string pattern;  // 词法模式（literal / {ID} / {NUM}）
+    std::string pattern;  // 词法模式（literal / {ID} / {NUM} / 正则）
+    bool regex = false;   // pattern 为正则（.lex 中写作 /.../，此处已去掉定界符）
 };
 
 /*
  * RuleSet
  * =======
- * 规则集合
+ * 规则集合，以及由规则定义的 Token 种类
  */
 struct RuleSet {
     std::vector<LexerRule> rules;
+    TokenKinds kinds;
 };
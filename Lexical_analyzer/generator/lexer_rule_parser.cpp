@@ -4,53 +4,15 @@
 #include <sstream>
 #include <stdexcept>
 
-/*
- * tokenFromString
- * ===============
- * 将规则文件中的 token 名称映射为 TokenType
- */
-TokenType LexerRuleParser::tokenFromString(const std::string& name) {
-    if (name == "ID") return TokenType::ID;
-    if (name == "NUM") return TokenType::NUM;
-
-    if (name == "INT") return TokenType::INT;
-    if (name == "VOID") return TokenType::VOID;
-    if (name == "IF") return TokenType::IF;
-    if (name == "ELSE") return TokenType::ELSE;
-    if (name == "WHILE") return TokenType::WHILE;
-    if (name == "RETURN") return TokenType::RETURN;
-
-    if (name == "PLUS") return TokenType::PLUS;
-    if (name == "MINUS") return TokenType::MINUS;
-    if (name == "MULT") return TokenType::MULT;
-    if (name == "DIV") return TokenType::DIV;
-
-    if (name == "ASSIGN") return TokenType::ASSIGN;
-    if (name == "EQ") return TokenType::EQ;
-    if (name == "NEQ") return TokenType::NEQ;
-    if (name == "LT") return TokenType::LT;
-    if (name == "GT") return TokenType::GT;
-    if (name == "LTE") return TokenType::LTE;
-    if (name == "GTE") return TokenType::GTE;
-
-    if (name == "LPAREN") return TokenType::LPAREN;
-    if (name == "RPAREN") return TokenType::RPAREN;
-    if (name == "LBRACE") return TokenType::LBRACE;
-    if (name == "RBRACE") return TokenType::RBRACE;
-    if (name == "SEMI") return TokenType::SEMI;
-    if (name == "COMMA") return TokenType::COMMA;
-    
-    if (name == "READ")  return TokenType::READ;
-    if (name == "WRITE") return TokenType::WRITE;
-
-
-    throw std::runtime_error("Unknown token name: " + name);
-}
-
 /*
  * parseFromFile
  * =============
- * 解析规则文件
+ * 解析规则文件，每行一条：<TOKEN 名称> <模式>
+ *
+ * - 模式以 '/' 开头并以 '/' 结尾（至少 3 个字符）时是正则，
+ *   取行内其余部分（可含空格），语法见 regex_parser.h
+ * - 否则取第一个单词：{ID} / {NUM} 或按字面量匹配（如 "/" "==" "while"）
+ * - Token 名称按首次出现的顺序编号，编号也是优先级（先出现者优先）
  */
 RuleSet LexerRuleParser::parseFromFile(const std::string& filename) {
     std::ifstream ifs(filename);
@@ -70,12 +32,41 @@ RuleSet LexerRuleParser::parseFromFile(const std::string& filename) {
 
         if (tokenName.empty() || pattern.empty()) continue;
 
+        TokenType reserved;
+        if (TokenKinds().find(tokenName, reserved)) {
+            throw std::runtime_error("Reserved token name: " + tokenName);
+        }
+
         LexerRule rule;
-        rule.type = tokenFromString(tokenName);
+        rule.type = rules.kinds.intern(tokenName);
         rule.pattern = pattern;
 
+        if (pattern[0] == '/') {
+            // 正则可含空格：改取名称之后的整行（去掉首尾空白）
+            std::string rest = line.substr(line.find('/', line.find(tokenName) +
+                                                          tokenName.size()));
+            rest.erase(rest.find_last_not_of(" \t\r") + 1);
+
+            if (rest.size() >= 3 && rest.back() == '/') {
+                rule.pattern = rest.substr(1, rest.size() - 2);
+                rule.regex = true;
+            }
+        }
+
         rules.rules.push_back(rule);
     }
 
+    // 只由一条字面量规则定义的种类记下字面量（供语法分析器绑定终结符）
+    std::vector<int> ruleCount(rules.kinds.size(), 0);
+    for (const auto& rule : rules.rules) {
+        ruleCount[(size_t)rule.type]++;
+    }
+    for (const auto& rule : rules.rules) {
+        bool literal = !rule.regex && rule.pattern != "{ID}" && rule.pattern != "{NUM}";
+        if (literal && ruleCount[(size_t)rule.type] == 1) {
+            rules.kinds.literals[(size_t)rule.type] = rule.pattern;
+        }
+    }
+
     return rules;
 }
@@ -7,13 +7,10 @@
  * LexerRuleParser
  * ===============
  * 解析 .lex 文件，生成 RuleSet
+ * Token 名称不再限定于固定集合：首次出现时登记到 RuleSet::kinds
  */
 class LexerRuleParser {
 public:
     // 从规则文件读取 RuleSet
     static RuleSet parseFromFile(const std::string& filename);
-
-private:
-    // token 名称 → TokenType
-    static TokenType tokenFromString(const std::string& name);
 };
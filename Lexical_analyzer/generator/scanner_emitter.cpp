@@ -0,0 +1,248 @@
+#include "scanner_emitter.h"
+
+#include <cctype>
+#include <map>
+#include <vector>
+
+/*
+ * case 标号：可打印的字母数字写成字符字面量，其余写成数值
+ */
+static std::string caseLabel(int b) {
+    if (std::isalnum(b)) {
+        return std::string("'") + (char)b + "'";
+    }
+    return std::to_string(b);
+}
+
+/*
+ * C++ 字符串字面量：转义引号与反斜杠，不可打印字节写成三位八进制
+ */
+static std::string stringLiteral(const std::string& s) {
+    static const char OCTAL[] = "01234567";
+    std::string out = "\"";
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (std::isprint(c)) {
+            out += (char)c;
+        } else {
+            out += '\\';
+            out += OCTAL[c >> 6];
+            out += OCTAL[(c >> 3) & 7];
+            out += OCTAL[c & 7];
+        }
+    }
+    return out + "\"";
+}
+
+std::string tokenLiteral(const TokenKinds& kinds, TokenType t) {
+    return "(TokenType)" + std::to_string((int)t) + " /* " + kinds.name(t) + " */";
+}
+
+/*
+ * 一个状态的标号块
+ *
+ * S<i>:
+ *     [接受态] last = p; tok = (TokenType)N;
+ *     if (p == end) goto done;
+ *     switch (*p++) {
+ *     case ...: goto S<j>;
+ *     default: goto done;
+ *     }
+ */
+static void emitState(const DFATable& table, int s, std::ostream& out) {
+    out << "    S" << s << ":\n";
+
+    if (table.accept[s]) {
+        out << "        last = p;\n"
+            << "        tok = " << tokenLiteral(table.kinds, table.acceptToken[s])
+            << ";\n";
+    }
+
+    // 按目标状态归并字节，保证生成顺序稳定
+    std::map<int, std::vector<int>> byTarget;
+    for (int b = 0; b < 256; ++b) {
+        int to = table.step(s, (unsigned char)b);
+        if (to != DFATable::DEAD) {
+            byTarget[to].push_back(b);
+        }
+    }
+
+    if (byTarget.empty()) {
+        out << "        goto done;\n\n";
+        return;
+    }
+
+    out << "        if (p == end) goto done;\n"
+        << "        switch (*p++) {\n";
+
+    for (auto& [to, bytes] : byTarget) {
+        for (size_t k = 0; k < bytes.size(); ++k) {
+            out << (k % 8 == 0 ? "        " : " ")
+                << "case " << caseLabel(bytes[k]) << ":"
+                << (k % 8 == 7 || k + 1 == bytes.size() ? "\n" : "");
+        }
+        out << "            goto S" << to << ";\n";
+    }
+
+    out << "        default:\n"
+        << "            goto done;\n"
+        << "        }\n\n";
+}
+
+void emitTokenKinds(const TokenKinds& kinds, std::ostream& out) {
+    out << "    // Token 种类（编号由规则文件分配）\n"
+        << "    static constexpr std::string_view tokenNames[" << kinds.size() << "] = {";
+    for (size_t k = 0; k < kinds.size(); ++k) {
+        out << (k % 4 == 0 ? "\n        " : " ") << "\"" << kinds.names[k] << "\",";
+    }
+    out << "\n    };\n\n"
+        << "    static constexpr std::string_view tokenName(TokenType t) {\n"
+        << "        return tokenNames[(size_t)t];\n"
+        << "    }\n\n";
+
+    out << "    // 只由一条字面量规则定义的种类的字面量（其余为空）\n"
+        << "    static constexpr std::string_view tokenLiterals[" << kinds.size() << "] = {";
+    for (size_t k = 0; k < kinds.size(); ++k) {
+        out << (k % 4 == 0 ? "\n        " : " ") << stringLiteral(kinds.literals[k]) << ",";
+    }
+    out << "\n    };\n\n";
+}
+
+void emitKeywordClassifier(const KeywordTable& keywords, const TokenKinds& kinds,
+                           std::ostream& out) {
+    if (keywords.empty()) {
+        out << "    // 把标识符归类为关键字（未启用关键字完美散列）\n"
+            << "    static constexpr TokenType classify(std::string_view, TokenType tok) {\n"
+            << "        return tok;\n"
+            << "    }\n\n";
+        return;
+    }
+
+    // 与 keyword_table.h 中的 keywordHash 保持一致
+    out << "    // 关键字完美散列（" << keywords.words.size() << " 个关键字）\n"
+        << "    static constexpr uint32_t keywordHash(std::string_view s, uint32_t seed) {\n"
+        << "        uint32_t h = 0x811c9dc5u ^ (seed * 0x9e3779b9u);\n"
+        << "        for (char c : s) {\n"
+        << "            h ^= (unsigned char)c;\n"
+        << "            h *= 0x01000193u;\n"
+        << "        }\n"
+        << "        h ^= h >> 15;\n"
+        << "        h *= 0x2c1b3c6du;\n"
+        << "        h ^= h >> 12;\n"
+        << "        return h;\n"
+        << "    }\n\n";
+
+    out << "    static constexpr uint32_t kwSeeds[" << keywords.seeds.size() << "] = {";
+    for (size_t k = 0; k < keywords.seeds.size(); ++k) {
+        out << (k % 8 == 0 ? "\n        " : " ") << keywords.seeds[k] << "u,";
+    }
+    out << "\n    };\n\n";
+
+    out << "    static constexpr std::string_view kwWords[" << keywords.words.size() << "] = {";
+    for (size_t k = 0; k < keywords.words.size(); ++k) {
+        out << (k % 4 == 0 ? "\n        " : " ") << "\"" << keywords.words[k] << "\",";
+    }
+    out << "\n    };\n\n";
+
+    out << "    static constexpr TokenType kwTokens[" << keywords.tokens.size() << "] = {";
+    for (size_t k = 0; k < keywords.tokens.size(); ++k) {
+        out << (k % 2 == 0 ? "\n        " : " ")
+            << tokenLiteral(kinds, keywords.tokens[k]) << ",";
+    }
+    out << "\n    };\n\n";
+
+    out << "    // 把标识符归类为关键字；不是关键字时原样返回 tok\n"
+        << "    static constexpr TokenType classify(std::string_view s, TokenType tok) {\n"
+        << "        if (tok != " << tokenLiteral(kinds, keywords.idToken) << ") return tok;\n"
+        << "        uint32_t b = keywordHash(s, 0) % " << keywords.seeds.size() << "u;\n"
+        << "        uint32_t slot = keywordHash(s, kwSeeds[b]) % " << keywords.words.size() << "u;\n"
+        << "        return kwWords[slot] == s ? kwTokens[slot] : tok;\n"
+        << "    }\n\n";
+}
+
+void emitScanner(const DFATable& table, std::ostream& out,
+                 const std::string& className, const std::string& origin) {
+    // ===== 文件头 =====
+    out << "// 由 lexer_gen --emit-scanner 从 " << origin
+        << " 生成，请勿手工修改\n"
+        << "#pragma once\n\n"
+        << "#include <cstddef>\n"
+        << "#include <cstdint>\n"
+        << "#include <string_view>\n"
+        << "#include \"token.h\"\n\n";
+
+    // ===== 驱动部分：与 Lexer::nextTokenView 行为一致 =====
+    out << "/*\n"
+        << " * " << className << "\n"
+        << " * 直接编码的 DFA 扫描器（" << table.numStates << " 个状态）\n"
+        << " */\n"
+        << "class " << className << " {\n"
+        << "public:\n"
+        << "    // input:  源代码（需比扫描器活得久，小于 4GB）\n"
+        << "    // fileId: 写入 SourceLoc 的文件编号\n"
+        << "    explicit " << className
+        << "(std::string_view input, uint32_t fileId = 0)\n"
+        << "        : src(input), fileId(fileId) {}\n\n"
+        << "    // 获取下一个 Token（lexeme 指向 input，不做拷贝）\n"
+        << "    TokenView nextTokenView() {\n"
+        << "        const size_t n = src.size();\n"
+        << "        while (pos < n && (src[pos] == ' ' || src[pos] == '\\t' ||\n"
+        << "                           src[pos] == '\\r' || src[pos] == '\\n')) {\n"
+        << "            ++pos;\n"
+        << "        }\n\n"
+        << "        SourceLoc loc{(uint32_t)pos, fileId};\n"
+        << "        if (pos >= n) {\n"
+        << "            return {TokenType::ENDFILE, std::string_view(), loc};\n"
+        << "        }\n\n"
+        << "        const unsigned char* in = (const unsigned char*)src.data();\n"
+        << "        TokenType tok = TokenType::ERROR;\n"
+        << "        size_t len = match(in + pos, in + n, tok);\n"
+        << "        if (len == 0) {\n"
+        << "            len = 1;    // 吃掉非法字符，防止死循环\n"
+        << "            tok = TokenType::ERROR;\n"
+        << "        }\n\n"
+        << "        std::string_view lexeme = src.substr(pos, len);\n"
+        << "        tok = classify(lexeme, tok);\n"
+        << "        pos += len;\n"
+        << "        return {tok, lexeme, loc};\n"
+        << "    }\n\n"
+        << "    // 获取下一个 Token（拷贝出 lexeme）\n"
+        << "    Token nextToken() { return nextTokenView().toToken(); }\n\n"
+        << "    // 从指定位置继续扫描\n"
+        << "    void seek(size_t newPos) { pos = newPos; }\n\n";
+
+    emitKeywordClassifier(table.keywords, table.kinds, out);
+    emitTokenKinds(table.kinds, out);
+
+    // ===== 状态机部分 =====
+    out << "    // 从 p 起做一次 Longest Match，返回匹配长度（0 表示无匹配）\n"
+        << "    static size_t match(const unsigned char* p,\n"
+        << "                        const unsigned char* end, TokenType& tok) {\n"
+        << "        const unsigned char* begin = p;\n"
+        << "        const unsigned char* last = p;\n";
+
+    if (table.start == DFATable::DEAD) {
+        out << "        (void)end;\n"
+            << "        (void)tok;\n"
+            << "        return (size_t)(last - begin);\n"
+            << "    }\n\n";
+    } else {
+        out << "        goto S" << table.start << ";\n\n";
+
+        for (int s = 0; s < table.numStates; ++s) {
+            emitState(table, s, out);
+        }
+
+        out << "    done:\n"
+            << "        return (size_t)(last - begin);\n"
+            << "    }\n\n";
+    }
+
+    out << "private:\n"
+        << "    std::string_view src;    // 输入源代码\n"
+        << "    size_t pos = 0;          // 当前扫描位置（字节索引）\n"
+        << "    uint32_t fileId = 0;     // 文件编号\n"
+        << "};\n";
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include "dfa_table.h"
+
+/*
+ * emitScanner
+ * ===========
+ * 代码生成后端（re2c 风格的直接编码扫描器）
+ *
+ * 将最小化 DFA 生成为一个自包含的 C++ 头文件：
+ * - 每个 DFA 状态一个标号块，转移为 switch + goto
+ * - 接受态在块内记录最近一次接受位置与 Token（Longest Match 内联）
+ * - 空白跳过 / ENDFILE / 非法字符 / 关键字归类的处理与 Lexer 一致
+ *
+ * 生成的代码只依赖 token/token.h，不依赖 automata/ 与运行时解释器
+ *
+ * table:     由最小化 DFA 降级得到的转移表（状态下标即标号编号）
+ * out:       输出流
+ * className: 生成的扫描器类名
+ * origin:    写进文件头注释的来源（通常为规则文件名）
+ */
+void emitScanner(const DFATable& table, std::ostream& out,
+                 const std::string& className, const std::string& origin);
+
+/*
+ * emitKeywordClassifier
+ * =====================
+ * 生成类内的 classify(lexeme, tok) 静态函数（constexpr）
+ * 启用关键字完美散列时一并生成散列函数与表，否则原样返回 tok
+ * 供 emitScanner / emitTableHeader 共用
+ */
+void emitKeywordClassifier(const KeywordTable& keywords, const TokenKinds& kinds,
+                           std::ostream& out);
+
+/*
+ * emitTokenKinds
+ * ==============
+ * 生成类内的 Token 名称表与 tokenName(tok) 静态函数（constexpr），
+ * 以及各种类的字面量表 tokenLiterals（供 static_lexer_check.cpp 自检）
+ * Token 编号由规则文件分配，生成的代码里只出现整数编号
+ */
+void emitTokenKinds(const TokenKinds& kinds, std::ostream& out);
+
+// 生成代码中的 Token 常量，如 (TokenType)4 /* ID */
+std::string tokenLiteral(const TokenKinds& kinds, TokenType t);
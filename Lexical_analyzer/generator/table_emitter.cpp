@@ -0,0 +1,63 @@
+#include "table_emitter.h"
+#include "scanner_emitter.h"
+
+/*
+ * 输出一个 constexpr 数组，每行 perLine 项
+ */
+template <class T, class Fmt>
+static void emitArray(std::ostream& out, const char* type, const char* name,
+                      const std::vector<T>& values, int perLine, Fmt fmt) {
+    out << "    static constexpr " << type << " " << name
+        << "[" << (values.empty() ? 1 : values.size()) << "] = {";
+
+    if (values.empty()) {
+        out << "};\n\n";
+        return;
+    }
+
+    for (size_t k = 0; k < values.size(); ++k) {
+        out << (k % perLine == 0 ? "\n        " : " ")
+            << fmt(values[k]) << ",";
+    }
+    out << "\n    };\n\n";
+}
+
+void emitTableHeader(const DFATable& table, std::ostream& out,
+                     const std::string& structName, const std::string& origin) {
+    auto num = [](int v) { return std::to_string(v); };
+
+    // ===== 文件头 =====
+    out << "// 由 lexer_gen --emit-table 从 " << origin
+        << " 生成，请勿手工修改\n"
+        << "#pragma once\n\n"
+        << "#include <cstddef>\n"
+        << "#include <string_view>\n"
+        << "#include \"token.h\"\n\n"
+        << "/*\n"
+        << " * " << structName << "\n"
+        << " * 编译期转移表（" << table.numStates << " 个状态，"
+        << table.numClasses << " 个等价类），配合 StaticLexer 使用\n"
+        << " */\n"
+        << "struct " << structName << " {\n"
+        << "    static constexpr int start = " << table.start << ";\n"
+        << "    static constexpr int numStates = " << table.numStates << ";\n"
+        << "    static constexpr int numClasses = " << table.numClasses << ";\n\n";
+
+    // ===== 各表 =====
+    std::vector<int> byteClass(table.byteClass.begin(), table.byteClass.end());
+    emitArray(out, "unsigned char", "byteClass", byteClass, 16, num);
+
+    emitArray(out, "int", "next", table.next, 16, num);
+
+    std::vector<int> accept(table.accept.begin(), table.accept.end());
+    emitArray(out, "bool", "accept", accept, 16,
+              [](int v) { return std::string(v ? "true" : "false"); });
+
+    emitArray(out, "TokenType", "acceptToken", table.acceptToken, 4,
+              [&](TokenType t) { return tokenLiteral(table.kinds, t); });
+
+    emitKeywordClassifier(table.keywords, table.kinds, out);
+    emitTokenKinds(table.kinds, out);
+
+    out << "};\n";
+}
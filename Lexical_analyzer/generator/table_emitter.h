@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include "dfa_table.h"
+
+/*
+ * emitTableHeader
+ * ===============
+ * 将最小化 DFA 的转移表生成为编译期常量（constexpr）头文件，
+ * 供 StaticLexer<Rules> 模板使用
+ *
+ * 生成的 Rules 结构体：
+ * - start / numStates / numClasses
+ * - byteClass[256]、next[numStates * numClasses]
+ * - accept[numStates]、acceptToken[numStates]
+ * - classify(lexeme, tok)：关键字完美散列归类（未启用时原样返回）
+ *
+ * 固定的规则集因此在编译期就已存在：没有运行时构造开销，
+ * 优化器也能看到整张表
+ *
+ * table:      由最小化 DFA 降级得到的转移表
+ * out:        输出流
+ * structName: 生成的 Rules 结构体名
+ * origin:     写进文件头注释的来源（通常为规则文件名）
+ */
+void emitTableHeader(const DFATable& table, std::ostream& out,
+                     const std::string& structName, const std::string& origin);
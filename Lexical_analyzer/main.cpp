@@ -1,80 +1,271 @@
+#include <cstdio>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
 
 #include "token.h"
 #include "lexer.h"
 #include "lexer_generator.h"
-
-/*
- * 读取整个文件
- */
-std::string readFile(const std::string& filename) {
-    std::ifstream ifs(filename);
-    if (!ifs.is_open()) {
-        throw std::runtime_error("Cannot open file: " + filename);
-    }
-    std::ostringstream oss;
-    oss << ifs.rdbuf();
-    return oss.str();
-}
+#include "dfa_table.h"
+#include "source_file.h"
+#include "stream_lexer.h"
+#include "parallel_lexer.h"
+#include "simd_scan.h"
+#include "scanner_emitter.h"
+#include "table_emitter.h"
+#include "token_writer.h"
+#include "token_stream_writer.h"
 
 int main(int argc, char* argv[]) {
     try {
         // ===== 参数检查 =====
         if (argc < 3) {
             std::ofstream ofs("output.txt");
-            ofs << "Usage: lexer_gen <source_file> <rule_file>\n";
+            ofs << "Usage: lexer_gen <source_file|-> <rule_file>"
+                   " [--threads=N] [--cache-dir=DIR] [--no-cache]"
+                   " [--keyword-hash] [--format=text|binary]"
+                   " [--construction=thompson|followpos] [--lazy[=KB]]\n"
+                   "       lexer_gen --emit-scanner <rule_file> <output_file>"
+                   " [--keyword-hash] [--construction=...]\n"
+                   "       lexer_gen --emit-table <rule_file> <output_file>"
+                   " [--keyword-hash] [--construction=...]\n"
+                   "  source '-' streams stdin (no size limit;"
+                   " at most 4GB with --format=binary)\n";
             return 1;
         }
 
+        // ===== 代码生成模式 =====
+        // --emit-scanner：直接编码的扫描器
+        // --emit-table：  供 StaticLexer 使用的编译期转移表
+        std::string mode = argv[1];
+        if (mode == "--emit-scanner" || mode == "--emit-table") {
+            if (argc < 4) {
+                throw std::runtime_error(mode + " needs <rule_file> <output_file>");
+            }
+
+            LexerGenerator gen;
+            gen.loadRuleFile(argv[2]);
+            for (int i = 4; i < argc; ++i) {
+                if (std::string(argv[i]) == "--keyword-hash") {
+                    gen.setKeywordHash(true);
+                } else if (std::string(argv[i]) == "--construction=thompson") {
+                    gen.setConstruction(DFAConstruction::THOMPSON);
+                } else if (std::string(argv[i]) == "--construction=followpos") {
+                    gen.setConstruction(DFAConstruction::FOLLOWPOS);
+                } else {
+                    throw std::runtime_error(std::string("Unknown option: ") + argv[i]);
+                }
+            }
+            DFATable table = gen.buildTable();
+
+            std::ofstream ofs(argv[3]);
+            if (!ofs) {
+                throw std::runtime_error(std::string("Cannot open file: ") + argv[3]);
+            }
+
+            if (mode == "--emit-scanner") {
+                emitScanner(table, ofs, "GeneratedLexer", argv[2]);
+            } else {
+                emitTableHeader(table, ofs, "GeneratedRules", argv[2]);
+            }
+            return 0;
+        }
+
         std::string sourceFile = argv[1];
         std::string ruleFile   = argv[2];
 
+        // ===== 可选参数 =====
+        // --threads=N：N 个线程并行扫描（0 表示按 CPU 核数），默认单线程
+        // --cache-dir=DIR：转移表缓存目录，默认 $LEXER_CACHE_DIR 或 .lexer_cache
+        // --no-cache：不读写缓存
+        // --keyword-hash：关键字移出自动机，按标识符匹配后查完美散列表
+        // --format=binary：output.txt 改为二进制 Token 流（Parser 可直接映射）
+        // --construction=followpos：由正则直接构造 DFA（结果相同，生成更快）
+        // --lazy[=KB]：不预先构造转移表，扫描时按需构造 DFA 状态（缓存上限 KB）
+        unsigned threads = 1;
+        bool lazyMode = false;
+        size_t lazyBudget = LazyDFA::DEFAULT_BUDGET;
+        bool keywordHash = false;
+        DFAConstruction construction = DFAConstruction::THOMPSON;
+        bool binary = false;
+        const char* envCache = std::getenv("LEXER_CACHE_DIR");
+        std::string cacheDir = envCache ? envCache : ".lexer_cache";
+        for (int i = 3; i < argc; ++i) {
+            std::string opt = argv[i];
+            if (opt.rfind("--threads=", 0) == 0) {
+                threads = (unsigned)std::stoul(opt.substr(10));
+            } else if (opt.rfind("--cache-dir=", 0) == 0) {
+                cacheDir = opt.substr(12);
+            } else if (opt == "--no-cache") {
+                cacheDir.clear();
+            } else if (opt == "--keyword-hash") {
+                keywordHash = true;
+            } else if (opt == "--format=text" || opt == "--format=binary") {
+                binary = (opt == "--format=binary");
+            } else if (opt == "--construction=thompson") {
+                construction = DFAConstruction::THOMPSON;
+            } else if (opt == "--construction=followpos") {
+                construction = DFAConstruction::FOLLOWPOS;
+            } else if (opt == "--lazy") {
+                lazyMode = true;
+            } else if (opt.rfind("--lazy=", 0) == 0) {
+                lazyMode = true;
+                lazyBudget = (size_t)std::stoul(opt.substr(7)) << 10;
+            } else {
+                throw std::runtime_error("Unknown option: " + opt);
+            }
+        }
+
         // ===== 读入源代码 =====
-        std::string code = readFile(sourceFile);
+        // "-" 表示从标准输入流式读取；否则只读映射整个文件（无拷贝）
+        bool streaming = (sourceFile == "-");
+        if (lazyMode && (streaming || threads != 1)) {
+            // 按需 DFA 的缓存在扫描时被修改，只支持单线程整体输入
+            throw std::runtime_error("--lazy cannot be combined with "
+                                     "streaming input or --threads");
+        }
+        std::unique_ptr<SourceFile> code;
+        if (!streaming) {
+            code = std::make_unique<SourceFile>(sourceFile);
+        }
 
         // ===== 使用规则文件生成扫描器 =====
         LexerGenerator gen;
         gen.loadRuleFile(ruleFile);
+        gen.setKeywordHash(keywordHash);
+        gen.setConstruction(construction);
 
-        DFA dfa = gen.buildDFA();   // 正则 → NFA → DFA → 最小化 DFA
+        // 正则 → NFA → DFA → 最小化 DFA → 扁平转移表（命中缓存时直接读入）
+        // 按需模式只构造位置自动机，不读写缓存
+        DFATable table;
+        std::unique_ptr<LazyDFA> lazy;
+        if (lazyMode) {
+            lazy = std::make_unique<LazyDFA>(gen.buildLazyDFA(lazyBudget));
+        } else {
+            table = gen.buildTable(cacheDir);
+        }
 
         // ===== 运行扫描器 =====
-        Lexer lexer(code, dfa);
+        std::unique_ptr<Lexer> lexer;
+        std::unique_ptr<StreamLexer> stream;
+        if (streaming) {
+            stream = std::make_unique<StreamLexer>(
+                [](char* buf, size_t cap) {
+                    return std::fread(buf, 1, cap, stdin);
+                },
+                table);
+            // 二进制 Token 流要写出整个换行表，流式输入因此限于 4GB
+            if (binary) {
+                stream->keepLineIndex();
+            }
+        } else if (lazy) {
+            lexer = std::make_unique<Lexer>(code->view(), *lazy);
+        } else {
+            lexer = std::make_unique<Lexer>(code->view(), table);
+        }
 
-        std::ostringstream output;
+        // 行列号按需解析：整体输入一次性建好换行索引，
+        // 流式输入由 StreamLexer 按当前窗口解析（token 一取出就输出）
+        LineIndex fileLines;
+        if (!streaming) {
+            fileLines = buildLineIndex(code->view());
+        }
+        auto resolve = [&](uint32_t offset) {
+            return streaming ? stream->resolve({offset, 0})
+                             : fileLines.resolve(offset);
+        };
+
+        // 边扫描边输出：文本格式写满缓冲区即落盘；二进制格式逐条写定长记录
+        // Token 名称由规则文件定义，随转移表（或按需 DFA）一起带出
+        const TokenKinds& kinds = lazy ? lazy->tokenKinds() : table.kinds;
+        std::unique_ptr<TokenWriter> textOut;
+        std::unique_ptr<TokenStreamWriter> binaryOut;
+        if (binary) {
+            binaryOut = std::make_unique<TokenStreamWriter>("output.txt", kinds);
+        } else {
+            textOut = std::make_unique<TokenWriter>("output.txt", kinds);
+        }
 
-        while (true) {
-            Token tok = lexer.nextToken();
+        // 输出一个 token；遇到词法错误时只保留报错并返回 false
+        auto emit = [&](TokenType type, std::string_view lexeme,
+                        uint32_t offset) {
+            if (type == TokenType::ERROR) {
+                LineCol lc = resolve(offset);
+                std::string message =
+                    "Lexical Error: illegal character '" +
+                    std::string(lexeme) + "'\n" +
+                    "at line " + std::to_string(lc.line) +
+                    ", column " + std::to_string(lc.column) + "\n";
 
-            if (tok.type == TokenType::ERROR) {
-                std::ofstream ofs("output.txt");
-                ofs << "Lexical Error: illegal character '"
-                    << tok.lexeme << "'\n"
-                    << "at line " << tok.line
-                    << ", column " << tok.column << "\n";
-                return 1;
+                if (binaryOut) {
+                    binaryOut->fail(message);
+                } else {
+                    textOut->fail(message);
+                }
+                return false;
             }
 
-            output << tokenName(tok.type);
+            if (binaryOut) {
+                binaryOut->write(type, lexeme, offset);
+            } else {
+                textOut->write(type, lexeme, resolve(offset));
+            }
+            return true;
+        };
 
-            if (!tok.lexeme.empty()) {
-                output << " : " << tok.lexeme;
+        // 输出一批 token；出错返回 false，读到 ENDFILE 时置 done
+        bool done = false;
+        auto emitBatch = [&](const TokenBatch& batch) {
+            for (size_t i = 0; i < batch.count; ++i) {
+                std::string_view lexeme =
+                    code->view().substr(batch.offset[i], batch.length[i]);
+                if (!emit(batch.type[i], lexeme, batch.offset[i])) {
+                    return false;
+                }
+                if (batch.type[i] == TokenType::ENDFILE) {
+                    done = true;
+                }
             }
+            return true;
+        };
 
-            output << " (" << tok.line << "," << tok.column << ")";
-            output << "\n";
+        if (lexer && threads != 1) {
+            // 整体输入 + 多线程：切块并行扫描，结果与单线程一致
+            if (!emitBatch(lexParallel(code->view(), table, threads))) {
+                return 1;
+            }
+        } else if (lexer) {
+            // 整体输入：按批取 token（结构数组），摊薄逐个调用的开销
+            TokenBatch batch;
 
-            if (tok.type == TokenType::ENDFILE) {
-                break;
+            while (!done) {
+                lexer->nextTokens(batch);
+                if (!emitBatch(batch)) {
+                    return 1;
+                }
+            }
+        } else {
+            // 流式输入：逐个取 token
+            while (true) {
+                Token tok = stream->nextToken();
+
+                if (!emit(tok.type, tok.lexeme, tok.loc.offset)) {
+                    return 1;
+                }
+                if (tok.type == TokenType::ENDFILE) {
+                    break;
+                }
             }
         }
 
-        std::ofstream ofs("output.txt");
-        ofs << output.str();
+        if (binaryOut) {
+            binaryOut->finish(streaming ? stream->lines() : fileLines);
+        } else {
+            textOut->flush();
+        }
     }
     catch (const std::exception& e) {
         std::ofstream ofs("output.txt");
@@ -1,45 +1,164 @@
 #include "lexer.h"
-#include "charset.h"
+#include "simd_scan.h"
+
+#include <stdexcept>
+
+/*
+ * SourceLoc 的偏移只有 32 位
+ */
+static std::string_view checkSize(std::string_view input) {
+    if (input.size() > UINT32_MAX) {
+        throw std::runtime_error("Source file too large (>= 4GB)");
+    }
+    return input;
+}
 
 /*
  * 构造函数
  */
-Lexer::Lexer(const std::string& input, DFA& dfa)
-    : src(input), dfa(dfa) {}
+Lexer::Lexer(std::string_view input, DFA& dfa, uint32_t fileId)
+    : src(checkSize(input)), fileId(fileId), dfa(&dfa),
+      keywords(&dfa.keywords) {}
+
+Lexer::Lexer(std::string_view input, const DFATable& table, uint32_t fileId)
+    : src(checkSize(input)), fileId(fileId), table(&table),
+      keywords(&table.keywords) {}
+
+Lexer::Lexer(std::string_view input, LazyDFA& lazy, uint32_t fileId)
+    : src(checkSize(input)), fileId(fileId), lazy(&lazy),
+      keywords(&lazy.keywordTable()) {}
 
 /*
  * nextToken
  * =========
- * 从当前位置扫描下一个 Token（Longest Match）
+ * 拥有文本的版本，由 nextTokenView 转换而来
  */
 Token Lexer::nextToken() {
+    return nextTokenView().toToken();
+}
+
+/*
+ * nextTokenView
+ * =============
+ * 从当前位置扫描下一个 Token（Longest Match）
+ * lexeme 是 src 上的视图，不分配内存
+ */
+TokenView Lexer::nextTokenView() {
     // 1. 跳过空白字符
     skipWhitespace();
 
     // 2. 文件结束
     if (pos >= src.size()) {
-        return {TokenType::ENDFILE, "", line, column};
+        return {TokenType::ENDFILE, std::string_view(),
+                {(uint32_t)pos, fileId}};
     }
 
     // 记录 token 起始位置
     size_t startPos = pos;
-    int startLine = line;
-    int startColumn = column;
+    SourceLoc loc{(uint32_t)startPos, fileId};
 
-    DFAState* cur = dfa.start;
+    // 3. DFA 试跑
+    TokenType acceptToken = TokenType::ERROR;
+    size_t lastAcceptPos = match(acceptToken);
 
-    // 记录最近一次接受态（Longest Match）
-    DFAState* lastAccept = nullptr;
-    size_t lastAcceptPos = pos;
+    // 4. 成功匹配（Longest Match）
+    if (lastAcceptPos > startPos) {
+        // 真正推进输入指针
+        pos = lastAcceptPos;
 
-    // 用 i 在 DFA 上“试跑”，不真正吃字符
-    size_t i = pos;
+        std::string_view lexeme = src.substr(startPos, lastAcceptPos - startPos);
+        return {keywords->classify(lexeme, acceptToken), lexeme, loc};
+    }
 
-    // 3. DFA 试跑
-    while (i < src.size()) {
-        char ch = src[i];
+    // 5. 词法错误：非法字符
+    pos++;  // 吃掉非法字符，防止死循环
+
+    return {
+        TokenType::ERROR,
+        src.substr(startPos, 1),
+        loc
+    };
+}
+
+/*
+ * nextTokens
+ * ==========
+ * 批量扫描：一次调用填满 out 的各列，
+ * 不构造中间 Token，也不逐个返回
+ */
+size_t Lexer::nextTokens(TokenBatch& out) {
+    const size_t cap = out.capacity();
+    if (cap == 0) {
+        // 一个 token 都放不下就永远到不了 ENDFILE，调用方的循环不会结束
+        throw std::runtime_error("TokenBatch capacity must be positive");
+    }
+    out.count = 0;
+    out.fileId = fileId;
+
+    while (out.count < cap) {
+        skipWhitespace();
+
+        size_t k = out.count++;
+        out.offset[k] = (uint32_t)pos;
+
+        // 文件结束
+        if (pos >= src.size()) {
+            out.type[k] = TokenType::ENDFILE;
+            out.length[k] = 0;
+            break;
+        }
+
+        // Longest Match；没有匹配时吃掉一个非法字符
+        TokenType tok = TokenType::ERROR;
+        size_t endPos = match(tok);
+        if (endPos == pos) {
+            endPos = pos + 1;
+        }
+
+        out.type[k] = keywords->classify(src.substr(pos, endPos - pos), tok);
+        out.length[k] = (uint32_t)(endPos - pos);
+        pos = endPos;
+
+        if (tok == TokenType::ERROR) {
+            break;
+        }
+    }
+    return out.count;
+}
+
+/*
+ * seek
+ * ====
+ * 跳到 pos 处继续扫描
+ */
+void Lexer::seek(size_t newPos) {
+    pos = newPos;
+}
+
+/*
+ * match
+ * =====
+ * 按运行模式分派
+ */
+size_t Lexer::match(TokenType& tok) const {
+    if (table) return matchTable(tok);
+    if (lazy) return matchLazy(tok);
+    return matchGraph(tok);
+}
+
+/*
+ * matchGraph
+ * ==========
+ * 指针图模式：沿 DFAState::trans 试跑，不真正吃字符
+ */
+size_t Lexer::matchGraph(TokenType& tok) const {
+    DFAState* cur = dfa->start;
+
+    // 记录最近一次接受态（Longest Match）
+    size_t lastAcceptPos = pos;
 
-        auto it = cur->trans.find(ch);
+    for (size_t i = pos; i < src.size(); ) {
+        auto it = cur->trans.find(dfa->classes.of((unsigned char)src[i]));
         if (it == cur->trans.end()) {
             break;
         }
@@ -48,66 +167,84 @@ Token Lexer::nextToken() {
         i++;
 
         if (cur->isAccept) {
-            lastAccept = cur;
+            tok = cur->acceptToken;
             lastAcceptPos = i;
         }
     }
+    return lastAcceptPos;
+}
 
-    // 4. 成功匹配（Longest Match）
-    if (lastAccept) {
-        // 真正推进输入指针（只能用 advance）
-        while (pos < lastAcceptPos) {
-            advance();
-        }
+/*
+ * matchTable
+ * ==========
+ * 转移表模式：每个字节一次类映射 + 一次下标访问
+ * 落在自环状态（标识符 / 数字尾部）时改为向量化整段扫描
+ */
+size_t Lexer::matchTable(TokenType& tok) const {
+    const int* next = table->next.data();
+    const unsigned char* byteClass = table->byteClass.data();
+    const size_t numClasses = (size_t)table->numClasses;
+    const unsigned char* accept = table->accept.data();
+    const ByteRanges* selfLoop = table->selfLoop.data();
+    const unsigned char* in = (const unsigned char*)src.data();
+    const size_t n = src.size();
+
+    int s = table->start;
+    size_t lastAcceptPos = pos;
 
-        return {
-            lastAccept->acceptToken,
-            src.substr(startPos, lastAcceptPos - startPos),
-            startLine,
-            startColumn
-        };
-    }
+    for (size_t i = pos; i < n; ) {
+        s = next[(size_t)s * numClasses + byteClass[in[i]]];
+        if (s == DFATable::DEAD) {
+            break;
+        }
+        i++;
 
-    // 5. 词法错误：非法字符
-    char badChar = src[pos];
-    advance();  // 吃掉非法字符，防止死循环
+        // 自环状态：整段吃掉留在本状态的字节
+        if (selfLoop[s].count > 0) {
+            i += scanByteRanges(src.data() + i, n - i, selfLoop[s]);
+        }
 
-    return {
-        TokenType::ERROR,
-        std::string(1, badChar),
-        startLine,
-        startColumn
-    };
+        if (accept[s]) {
+            tok = table->acceptToken[s];
+            lastAcceptPos = i;
+        }
+    }
+    return lastAcceptPos;
 }
 
 /*
- * advance
- * =======
- * 吃掉一个字符，并维护行列号
+ * matchLazy
+ * =========
+ * 按需模式：转移未缓存时由 LazyDFA 现场计算
+ * 状态下标只在相邻两步之间使用（缓存清空后会重新编号）
  */
-void Lexer::advance() {
-    char c = src[pos++];
-
-    if (c == '\n') {
-        line++;
-        column = 1;
-    } else {
-        column++;
+size_t Lexer::matchLazy(TokenType& tok) const {
+    const unsigned char* in = (const unsigned char*)src.data();
+    const size_t n = src.size();
+
+    int s = lazy->start();
+    size_t lastAcceptPos = pos;
+
+    for (size_t i = pos; i < n; ) {
+        s = lazy->step(s, in[i]);
+        if (s == LazyDFA::DEAD) {
+            break;
+        }
+        i++;
+
+        if (lazy->isAccept(s)) {
+            tok = lazy->acceptToken(s);
+            lastAcceptPos = i;
+        }
     }
+    return lastAcceptPos;
 }
 
 /*
  * skipWhitespace
  * ==============
- * 跳过空白字符（空格 / 制表 / 换行）
+ * 跳过空白字符（空格 / 制表 / 换行），整段向量化扫描
  */
 void Lexer::skipWhitespace() {
-    while (pos < src.size()) {
-        unsigned char c = (unsigned char)src[pos];
-        if (isBlank(c) || isNewline(c)) {
-            advance();
-        } else {
-            break;
-        }
-    }
+    pos += scanBlanks(src.data() + pos, src.size() - pos);
 }
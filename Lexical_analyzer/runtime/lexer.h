@@ -1,36 +1,73 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include "token.h"
 #include "dfa.h"
+#include "dfa_table.h"
+#include "lazy_dfa.h"
 
 /*
  * Lexer
  * =====
  * 基于 DFA 的词法分析器（Longest Match）
+ *
+ * 三种运行模式：
+ * - 指针图模式：直接遍历 DFAState::trans
+ * - 转移表模式：在 DFATable 上按下标查表（更快）
+ * - 按需模式：在 LazyDFA 上扫描，用到的状态才构造（启动快，内存有上限）
+ *
+ * Token 只记录 SourceLoc（字节偏移 + 文件编号），
+ * 扫描时不逐字节维护行列号
  */
 class Lexer {
 public:
-    // input: 源代码字符串
-    // dfa:   已构造完成的 DFA
-    Lexer(const std::string& input, DFA& dfa);
+    // input:  源代码（字符串或文件映射，需比 Lexer 活得久，小于 4GB）
+    // dfa:    已构造完成的 DFA
+    // fileId: 写入 SourceLoc 的文件编号
+    Lexer(std::string_view input, DFA& dfa, uint32_t fileId = 0);
 
-    // 获取下一个 Token
+    // input:  源代码（字符串或文件映射，需比 Lexer 活得久，小于 4GB）
+    // table:  由最小化 DFA 降级得到的转移表
+    // fileId: 写入 SourceLoc 的文件编号
+    Lexer(std::string_view input, const DFATable& table, uint32_t fileId = 0);
+
+    // input:  源代码（字符串或文件映射，需比 Lexer 活得久，小于 4GB）
+    // lazy:   按需 DFA（扫描时会写入其缓存）
+    // fileId: 写入 SourceLoc 的文件编号
+    Lexer(std::string_view input, LazyDFA& lazy, uint32_t fileId = 0);
+
+    // 获取下一个 Token（lexeme 指向 input，不做拷贝）
+    TokenView nextTokenView();
+
+    // 获取下一个 Token（拷贝出 lexeme）
     Token nextToken();
 
+    // 批量获取至多 out.capacity() 个 Token，返回实际个数
+    // ENDFILE 或 ERROR 之后本批结束；容量为 0 时抛出异常
+    size_t nextTokens(TokenBatch& out);
+
+    // 从指定位置继续扫描
+    void seek(size_t pos);
+
 private:
-    const std::string& src;  // 输入源代码
+    std::string_view src;    // 输入源代码
     size_t pos = 0;          // 当前扫描位置（字节索引）
+    uint32_t fileId = 0;     // 文件编号
 
-    int line = 1;            // 当前行号（从 1 开始）
-    int column = 1;          // 当前列号（从 1 开始）
-
-    DFA& dfa;                // DFA 引用
+    DFA* dfa = nullptr;                 // 指针图模式
+    const DFATable* table = nullptr;    // 转移表模式
+    LazyDFA* lazy = nullptr;            // 按需模式
+    const KeywordTable* keywords = nullptr; // 关键字完美散列（两种模式共用）
 
 private:
-    // 吃掉一个字符，并同步维护行列号
-    void advance();
-
     // 跳过空白字符（space / tab / newline）
     void skipWhitespace();
+
+    // 从 pos 试跑 DFA，返回最近一次接受的结束位置
+    // 没有匹配时返回 pos，tok 保持不变
+    size_t match(TokenType& tok) const;
+    size_t matchGraph(TokenType& tok) const;
+    size_t matchTable(TokenType& tok) const;
+    size_t matchLazy(TokenType& tok) const;
 };
@@ -0,0 +1,172 @@
+#include "parallel_lexer.h"
+#include "lexer.h"
+#include "simd_scan.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+/*
+ * 单块扫描的结果
+ */
+namespace {
+
+struct ChunkToken {
+    TokenType type;
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct Chunk {
+    size_t begin = 0;   // 重启点（行首）
+    size_t end = 0;     // 下一块的重启点
+    std::vector<ChunkToken> tokens;
+};
+
+// 小于该大小的块不值得并行
+constexpr size_t MIN_CHUNK = 64 * 1024;
+
+}
+
+/*
+ * 切块：等分点之后的第一个行首作为重启点
+ */
+static std::vector<Chunk> splitChunks(std::string_view src, size_t count) {
+    std::vector<Chunk> chunks;
+    size_t begin = 0;
+
+    for (size_t k = 1; k <= count && begin < src.size(); ++k) {
+        size_t end = src.size();
+        if (k < count) {
+            size_t guess = std::max(begin, src.size() / count * k);
+            const void* nl = std::memchr(src.data() + guess, '\n',
+                                         src.size() - guess);
+            end = nl ? (size_t)((const char*)nl - src.data()) + 1 : src.size();
+        }
+        if (end <= begin) continue;
+
+        Chunk c;
+        c.begin = begin;
+        c.end = end;
+        chunks.push_back(std::move(c));
+        begin = end;
+    }
+    return chunks;
+}
+
+/*
+ * 扫描一个 token 并转成 ChunkToken
+ */
+static ChunkToken scanOne(Lexer& lexer) {
+    TokenView tok = lexer.nextTokenView();
+    return {tok.type, tok.loc.offset, (uint32_t)tok.lexeme.size()};
+}
+
+/*
+ * 推测扫描一块：从 begin 开始，扫描到下一个 token 起点越过 end 为止
+ * 最后一块一直扫描到 ENDFILE；遇到 ERROR 即停止
+ */
+static void lexChunk(std::string_view src, const DFATable& table,
+                     Chunk& c, bool last) {
+    Lexer lexer(src, table);
+    lexer.seek(c.begin);
+
+    while (true) {
+        ChunkToken t = scanOne(lexer);
+        if (!last && t.offset >= c.end) break;
+
+        c.tokens.push_back(t);
+
+        if (t.type == TokenType::ENDFILE || t.type == TokenType::ERROR) {
+            break;
+        }
+    }
+}
+
+TokenBatch lexParallel(std::string_view src, const DFATable& table,
+                       unsigned threads, uint32_t fileId) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // ===== 1. 切块 =====
+    size_t count = std::min<size_t>((size_t)threads * 4,
+                                    std::max<size_t>(1, src.size() / MIN_CHUNK));
+    std::vector<Chunk> chunks = splitChunks(src, count);
+
+    // ===== 2. 线程池推测扫描 =====
+    std::atomic<size_t> nextChunk{0};
+    auto worker = [&]() {
+        for (size_t k; (k = nextChunk++) < chunks.size(); ) {
+            lexChunk(src, table, chunks[k], k + 1 == chunks.size());
+        }
+    };
+
+    std::vector<std::thread> pool;
+    unsigned spawn = (unsigned)std::min<size_t>(threads, chunks.size());
+    for (unsigned t = 1; t < spawn; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& th : pool) {
+        th.join();
+    }
+
+    // ===== 3. 拼接校验 =====
+    std::vector<ChunkToken> out;
+    Lexer resync(src, table);
+
+    size_t cur = 0;          // 下一个 token 从此处开始扫描
+    bool done = false;
+
+    // 采用一个 token，并把 cur 移到其末尾
+    auto accept = [&](const ChunkToken& t) {
+        out.push_back(t);
+        cur = (size_t)t.offset + t.length;
+        done = t.type == TokenType::ENDFILE || t.type == TokenType::ERROR;
+    };
+
+    for (auto& c : chunks) {
+        while (!done) {
+            // 顺序扫描时下一个 token 的真实起点
+            size_t q = cur + scanBlanks(src.data() + cur, src.size() - cur);
+
+            auto it = std::lower_bound(
+                c.tokens.begin(), c.tokens.end(), q,
+                [](const ChunkToken& t, size_t off) { return t.offset < off; });
+
+            // 对上了：本块从这里起的 token 与顺序扫描一致，直接采用
+            if (it != c.tokens.end() && it->offset == q) {
+                out.insert(out.end(), it, c.tokens.end() - 1);
+                accept(c.tokens.back());
+                break;
+            }
+
+            // 已越过本块：交给下一块
+            if (q >= c.end) break;
+
+            // 没对上：在边界处顺序重扫一个 token 后再尝试同步
+            resync.seek(cur);
+            accept(scanOne(resync));
+        }
+    }
+
+    // 收尾：最后一块未能覆盖到结尾时，顺序扫描剩余部分
+    resync.seek(cur);
+    while (!done) {
+        accept(scanOne(resync));
+    }
+
+    // ===== 输出为结构数组 =====
+    TokenBatch batch(out.size());
+    for (size_t k = 0; k < out.size(); ++k) {
+        batch.type[k] = out[k].type;
+        batch.offset[k] = out[k].offset;
+        batch.length[k] = out[k].length;
+    }
+    batch.fileId = fileId;
+    batch.count = out.size();
+    return batch;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string_view>
+#include "token.h"
+#include "dfa_table.h"
+
+/*
+ * lexParallel
+ * ===========
+ * 多线程扫描整个输入，输出与单线程 Lexer 逐 token 完全一致
+ *
+ * 流程：
+ * 1. 切块：按大小等分，起点挪到下一个换行之后（猜测的重启点）
+ * 2. 推测扫描：线程池中每块独立从起点扫描
+ * 3. 拼接校验：顺序检查上一块的结束位置是否落在本块的某个 token 起点上，
+ *    对上即直接采用；对不上则在边界处顺序重扫，直到重新同步
+ *
+ * token 只记录字节偏移（SourceLoc），行列号由 LineIndex 统一解析，
+ * 因此各块之间无需修正行列号
+ *
+ * 结果以 TokenBatch 返回（count 为 token 总数，以 ENDFILE 或 ERROR 结尾）
+ *
+ * threads: 工作线程数，0 表示使用硬件并发数
+ */
+TokenBatch lexParallel(std::string_view src, const DFATable& table,
+                       unsigned threads = 0, uint32_t fileId = 0);
@@ -0,0 +1,240 @@
+#include "simd_scan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LEXER_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+/*
+ * 标量实现：逐字节判断
+ */
+static size_t scanBlanksPortable(const char* p, size_t n) {
+    size_t i = 0;
+    while (i < n && (isBlank((unsigned char)p[i]) ||
+                     isNewline((unsigned char)p[i]))) {
+        ++i;
+    }
+    return i;
+}
+
+static size_t scanByteRangesPortable(const char* p, size_t n,
+                                     const ByteRanges& r) {
+    size_t i = 0;
+    while (i < n && r.contains((unsigned char)p[i])) ++i;
+    return i;
+}
+
+static void scanNewlinesPortable(const char* p, size_t n, uint32_t base,
+                                 LineIndex& index) {
+    for (size_t i = 0; i < n; ++i) {
+        if (isNewline((unsigned char)p[i])) {
+            index.addNewline(base + (uint32_t)i);
+        }
+    }
+}
+
+#ifdef LEXER_SIMD_X86
+
+__attribute__((target("sse2")))
+static size_t scanBlanksSSE2(const char* p, size_t n) {
+    const __m128i sp = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    size_t i = 0;
+    while (i + 16 <= n) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        __m128i bl = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(v, sp), _mm_cmpeq_epi8(v, tab)),
+            _mm_or_si128(_mm_cmpeq_epi8(v, cr), _mm_cmpeq_epi8(v, lf)));
+
+        unsigned stop = ~(unsigned)_mm_movemask_epi8(bl) & 0xFFFFu;
+        if (stop) {
+            return i + (size_t)__builtin_ctz(stop);
+        }
+        i += 16;
+    }
+    return i + scanBlanksPortable(p + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static size_t scanBlanksAVX2(const char* p, size_t n) {
+    const __m256i sp = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    size_t i = 0;
+    while (i + 32 <= n) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i bl = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, sp),
+                            _mm256_cmpeq_epi8(v, tab)),
+            _mm256_or_si256(_mm256_cmpeq_epi8(v, cr),
+                            _mm256_cmpeq_epi8(v, lf)));
+
+        unsigned stop = ~(unsigned)_mm256_movemask_epi8(bl);
+        if (stop) {
+            return i + (size_t)__builtin_ctz(stop);
+        }
+        i += 32;
+    }
+    return i + scanBlanksPortable(p + i, n - i);
+}
+
+/*
+ * 区间判断：(v - lo) 按无符号饱和减去 (hi - lo) 为 0 即在区间内
+ * 返回属于任一区间的字节掩码
+ */
+__attribute__((target("sse2")))
+static inline __m128i inRangesSSE2(__m128i v, const ByteRanges& r) {
+    __m128i hit = _mm_setzero_si128();
+    for (int k = 0; k < r.count; ++k) {
+        __m128i t = _mm_sub_epi8(v, _mm_set1_epi8((char)r.lo[k]));
+        __m128i over = _mm_subs_epu8(t, _mm_set1_epi8((char)(r.hi[k] - r.lo[k])));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(over, _mm_setzero_si128()));
+    }
+    return hit;
+}
+
+__attribute__((target("sse2")))
+static size_t scanByteRangesSSE2(const char* p, size_t n, const ByteRanges& r) {
+    size_t i = 0;
+    while (i + 16 <= n) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        unsigned stop = ~(unsigned)_mm_movemask_epi8(inRangesSSE2(v, r)) & 0xFFFFu;
+        if (stop) {
+            return i + (size_t)__builtin_ctz(stop);
+        }
+        i += 16;
+    }
+    return i + scanByteRangesPortable(p + i, n - i, r);
+}
+
+__attribute__((target("avx2")))
+static size_t scanByteRangesAVX2(const char* p, size_t n, const ByteRanges& r) {
+    size_t i = 0;
+    while (i + 32 <= n) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        __m256i hit = _mm256_setzero_si256();
+        for (int k = 0; k < r.count; ++k) {
+            __m256i t = _mm256_sub_epi8(v, _mm256_set1_epi8((char)r.lo[k]));
+            __m256i over = _mm256_subs_epu8(
+                t, _mm256_set1_epi8((char)(r.hi[k] - r.lo[k])));
+            hit = _mm256_or_si256(
+                hit, _mm256_cmpeq_epi8(over, _mm256_setzero_si256()));
+        }
+        unsigned stop = ~(unsigned)_mm256_movemask_epi8(hit);
+        if (stop) {
+            return i + (size_t)__builtin_ctz(stop);
+        }
+        i += 32;
+    }
+    return i + scanByteRangesPortable(p + i, n - i, r);
+}
+
+/*
+ * 换行扫描：比较得到掩码后逐位取出换行位置
+ */
+__attribute__((target("sse2")))
+static void scanNewlinesSSE2(const char* p, size_t n, uint32_t base,
+                             LineIndex& index) {
+    const __m128i lf = _mm_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, lf));
+        while (mask) {
+            index.addNewline(base + (uint32_t)(i + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+    scanNewlinesPortable(p + i, n - i, base + (uint32_t)i, index);
+}
+
+__attribute__((target("avx2")))
+static void scanNewlinesAVX2(const char* p, size_t n, uint32_t base,
+                             LineIndex& index) {
+    const __m256i lf = _mm256_set1_epi8('\n');
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, lf));
+        while (mask) {
+            index.addNewline(base + (uint32_t)(i + __builtin_ctz(mask)));
+            mask &= mask - 1;
+        }
+    }
+    scanNewlinesPortable(p + i, n - i, base + (uint32_t)i, index);
+}
+
+#endif
+
+/*
+ * 选择实现（只在首次调用时判断一次）
+ */
+#ifdef LEXER_SIMD_X86
+template <class Fn>
+static Fn selectImpl(Fn avx2, Fn sse2, Fn portable) {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return avx2;
+    if (__builtin_cpu_supports("sse2")) return sse2;
+    return portable;
+}
+#endif
+
+size_t scanBlanks(const char* p, size_t n) {
+    // token 之间大多没有或只有一个空白，先走标量快速路径
+    if (n < 16 ||
+        !(isBlank((unsigned char)p[0]) || isNewline((unsigned char)p[0])) ||
+        !(isBlank((unsigned char)p[1]) || isNewline((unsigned char)p[1]))) {
+        return scanBlanksPortable(p, n);
+    }
+
+#ifdef LEXER_SIMD_X86
+    using Fn = size_t (*)(const char*, size_t);
+    static const Fn impl =
+        selectImpl<Fn>(scanBlanksAVX2, scanBlanksSSE2, scanBlanksPortable);
+    return impl(p, n);
+#else
+    return scanBlanksPortable(p, n);
+#endif
+}
+
+size_t scanByteRanges(const char* p, size_t n, const ByteRanges& ranges) {
+    // 短的标识符 / 数字占多数，不足一个向量时直接走标量
+    if (n < 16) {
+        return scanByteRangesPortable(p, n, ranges);
+    }
+
+#ifdef LEXER_SIMD_X86
+    using Fn = size_t (*)(const char*, size_t, const ByteRanges&);
+    static const Fn impl =
+        selectImpl<Fn>(scanByteRangesAVX2, scanByteRangesSSE2,
+                       scanByteRangesPortable);
+    return impl(p, n, ranges);
+#else
+    return scanByteRangesPortable(p, n, ranges);
+#endif
+}
+
+void scanNewlines(const char* p, size_t n, uint32_t base, LineIndex& index) {
+#ifdef LEXER_SIMD_X86
+    using Fn = void (*)(const char*, size_t, uint32_t, LineIndex&);
+    static const Fn impl =
+        selectImpl<Fn>(scanNewlinesAVX2, scanNewlinesSSE2,
+                       scanNewlinesPortable);
+    impl(p, n, base, index);
+#else
+    scanNewlinesPortable(p, n, base, index);
+#endif
+}
+
+LineIndex buildLineIndex(std::string_view src) {
+    LineIndex index;
+    scanNewlines(src.data(), src.size(), 0, index);
+    return index;
+}
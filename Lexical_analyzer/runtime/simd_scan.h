@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "charset.h"
+#include "source_loc.h"
+
+/*
+ * 向量化扫描工具
+ * ==============
+ * 实现：
+ * - AVX2：每次比较 32 字节
+ * - SSE2：每次比较 16 字节
+ * - 标量：其他平台 / 尾部
+ * 首次调用时按 CPU 支持情况选定实现
+ */
+
+/*
+ * scanBlanks
+ * ==========
+ * 返回 [p, p + n) 中前导空白（空格 / 制表 / 回车 / 换行）的长度
+ */
+size_t scanBlanks(const char* p, size_t n);
+
+/*
+ * scanByteRanges
+ * ==============
+ * 返回 [p, p + n) 中落在 ranges 内的最长前缀长度
+ * 用于 DFA 自环状态：整段标识符 / 数字一次性吃掉
+ */
+size_t scanByteRanges(const char* p, size_t n, const ByteRanges& ranges);
+
+/*
+ * scanNewlines
+ * ============
+ * 把 [p, p + n) 中每个 '\n' 的偏移（加上 base）追加到 index
+ */
+void scanNewlines(const char* p, size_t n, uint32_t base, LineIndex& index);
+
+/*
+ * buildLineIndex
+ * ==============
+ * 为整个文件建立换行索引
+ */
+LineIndex buildLineIndex(std::string_view src);
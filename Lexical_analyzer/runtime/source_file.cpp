@@ -0,0 +1,117 @@
+#include "source_file.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+SourceFile::SourceFile(const std::string& filename) {
+    HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING,
+                              FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    LARGE_INTEGER fileSize;
+    bool regular = GetFileType(file) == FILE_TYPE_DISK &&
+                   GetFileSizeEx(file, &fileSize);
+
+    // ===== 普通文件：只读映射 =====
+    if (regular && fileSize.QuadPart > 0) {
+        mapHandle = CreateFileMappingA(file, nullptr, PAGE_READONLY,
+                                       0, 0, nullptr);
+        if (mapHandle) {
+            mapping = MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+            if (!mapping) {
+                CloseHandle(mapHandle);
+                mapHandle = nullptr;
+            }
+        }
+    }
+
+    if (mapping) {
+        data = static_cast<const char*>(mapping);
+        size = (size_t)fileSize.QuadPart;
+        CloseHandle(file);
+        return;
+    }
+
+    // ===== 管道等：缓冲读取 =====
+    char chunk[1 << 16];
+    DWORD got = 0;
+    BOOL ok;
+    while ((ok = ReadFile(file, chunk, sizeof(chunk), &got, nullptr)) && got > 0) {
+        buffer.append(chunk, got);
+    }
+    // 管道写端关闭时 ReadFile 以 ERROR_BROKEN_PIPE 失败，等同于读到末尾
+    DWORD error = ok ? ERROR_SUCCESS : GetLastError();
+    CloseHandle(file);
+
+    if (error != ERROR_SUCCESS && error != ERROR_BROKEN_PIPE) {
+        throw std::runtime_error("Cannot read file: " + filename);
+    }
+
+    data = buffer.data();
+    size = buffer.size();
+}
+
+SourceFile::~SourceFile() {
+    if (mapping) UnmapViewOfFile(mapping);
+    if (mapHandle) CloseHandle(mapHandle);
+}
+
+#else
+
+SourceFile::SourceFile(const std::string& filename) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    struct stat st;
+    bool regular = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+
+    // ===== 普通文件：只读映射 =====
+    if (regular && st.st_size > 0) {
+        void* p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ,
+                         MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ::madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+            mapping = p;
+            data = static_cast<const char*>(p);
+            size = (size_t)st.st_size;
+            ::close(fd);
+            return;
+        }
+    }
+
+    // ===== 管道等：缓冲读取 =====
+    char chunk[1 << 16];
+    ssize_t got;
+    while ((got = ::read(fd, chunk, sizeof(chunk))) > 0) {
+        buffer.append(chunk, (size_t)got);
+    }
+    ::close(fd);
+
+    if (got < 0) {
+        throw std::runtime_error("Cannot read file: " + filename);
+    }
+
+    data = buffer.data();
+    size = buffer.size();
+}
+
+SourceFile::~SourceFile() {
+    if (mapping) ::munmap(mapping, size);
+}
+
+#endif
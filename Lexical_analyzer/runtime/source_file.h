@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/*
+ * SourceFile
+ * ==========
+ * 只读的源代码输入，Lexer 直接在其内容上扫描
+ *
+ * - 普通文件：只读映射（POSIX mmap / Win32 MapViewOfFile），不做拷贝
+ * - 管道 / 字符设备等无法映射的输入：退回到缓冲读取
+ *
+ * 映射的生命周期与对象一致，
+ * 因此 SourceFile 必须比使用它的 Lexer / TokenView 活得久
+ */
+class SourceFile {
+public:
+    explicit SourceFile(const std::string& filename);
+    ~SourceFile();
+
+    SourceFile(const SourceFile&) = delete;
+    SourceFile& operator=(const SourceFile&) = delete;
+
+    // 文件内容
+    std::string_view view() const { return {data, size}; }
+
+    // 是否为映射（否则为缓冲读取）
+    bool isMapped() const { return mapping != nullptr; }
+
+private:
+    const char* data = "";
+    size_t size = 0;
+
+    void* mapping = nullptr;   // 映射起始地址
+    std::string buffer;        // 缓冲读取的后备存储
+
+#ifdef _WIN32
+    void* mapHandle = nullptr; // CreateFileMapping 句柄
+#endif
+};
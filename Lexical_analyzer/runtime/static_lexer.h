@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "token.h"
+
+/*
+ * StaticLexer
+ * ===========
+ * 针对固定规则集特化的词法分析器（Longest Match）
+ *
+ * Rules 为 lexer_gen --emit-table 生成的编译期转移表（含关键字归类 classify）：
+ * - 没有运行时构造：不解析规则、不建 NFA / DFA、不分配转移表
+ * - 表是 constexpr 常量，优化器可以看到整个自动机
+ *
+ * 行为与 Lexer 的转移表模式一致（空白跳过 / ENDFILE / 非法字符 / 关键字归类）
+ */
+template <class Rules>
+class StaticLexer {
+    static_assert(Rules::numClasses >= 1, "Rules must have at least one class");
+
+public:
+    // input:  源代码（需比 StaticLexer 活得久，小于 4GB）
+    // fileId: 写入 SourceLoc 的文件编号
+    constexpr explicit StaticLexer(std::string_view input, uint32_t fileId = 0)
+        : src(input), fileId(fileId) {}
+
+    // 获取下一个 Token（lexeme 指向 input，不做拷贝）
+    constexpr TokenView nextTokenView() {
+        const size_t n = src.size();
+        while (pos < n && (src[pos] == ' ' || src[pos] == '\t' ||
+                           src[pos] == '\r' || src[pos] == '\n')) {
+            ++pos;
+        }
+
+        SourceLoc loc{(uint32_t)pos, fileId};
+        if (pos >= n) {
+            return {TokenType::ENDFILE, std::string_view(), loc};
+        }
+
+        TokenType tok = TokenType::ERROR;
+        size_t len = match(src, pos, tok);
+        if (len == 0) {
+            len = 1;    // 吃掉非法字符，防止死循环
+            tok = TokenType::ERROR;
+        }
+
+        std::string_view lexeme = src.substr(pos, len);
+        tok = Rules::classify(lexeme, tok);
+        pos += len;
+        return {tok, lexeme, loc};
+    }
+
+    // 获取下一个 Token（拷贝出 lexeme）
+    Token nextToken() { return nextTokenView().toToken(); }
+
+    // 从指定位置继续扫描
+    constexpr void seek(size_t newPos) { pos = newPos; }
+
+    // Token 名称（由规则文件定义）
+    static constexpr std::string_view tokenName(TokenType t) {
+        return Rules::tokenName(t);
+    }
+
+    // 从 s[from] 起做一次 Longest Match，返回匹配长度（0 表示无匹配）
+    // 可在常量表达式中求值
+    static constexpr size_t match(std::string_view s, size_t from,
+                                  TokenType& tok) {
+        int state = Rules::start;
+        size_t last = from;
+
+        for (size_t i = from; state >= 0 && i < s.size(); ) {
+            unsigned char c = (unsigned char)s[i++];
+            state = Rules::next[(size_t)state * Rules::numClasses +
+                                Rules::byteClass[c]];
+
+            if (state >= 0 && Rules::accept[state]) {
+                tok = Rules::acceptToken[state];
+                last = i;
+            }
+        }
+        return last - from;
+    }
+
+private:
+    std::string_view src;    // 输入源代码
+    size_t pos = 0;          // 当前扫描位置（字节索引）
+    uint32_t fileId = 0;     // 文件编号
+};
@@ -0,0 +1,162 @@
+#include "stream_lexer.h"
+#include "simd_scan.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/*
+ * 构造函数
+ */
+StreamLexer::StreamLexer(Reader reader, const DFATable& table,
+                         size_t bufferSize, uint32_t fileId)
+    : reader(std::move(reader)), table(table), fileId(fileId),
+      buf(bufferSize > 0 ? bufferSize : 1) {}
+
+/*
+ * nextToken
+ * =========
+ * 与 Lexer::nextToken 相同的 Longest Match，
+ * 试跑到窗口末尾时补充输入后继续，而不是直接截断 token
+ */
+Token StreamLexer::nextToken() {
+    // 1. 跳过空白字符
+    skipWhitespace();
+
+    // 2. 输入结束
+    if (pos >= lim && !fill()) {
+        return {TokenType::ENDFILE, "", here()};
+    }
+
+    // 3. DFA 试跑：用相对 token 起点的长度记位置，补充输入时 pos 会移动
+    int s = table.start;
+    size_t len = 0;
+    size_t acceptLen = 0;
+    TokenType acceptToken = TokenType::ERROR;
+
+    while (true) {
+        if (pos + len >= lim && !fill()) {
+            break;
+        }
+
+        s = table.step(s, (unsigned char)buf[pos + len]);
+        if (s == DFATable::DEAD) {
+            break;
+        }
+        len++;
+
+        // 自环状态：窗口内整段吃掉，到窗口末尾后由下一轮补充输入
+        const ByteRanges& loop = table.selfLoop[s];
+        if (loop.count > 0) {
+            len += scanByteRanges(buf.data() + pos + len, lim - pos - len, loop);
+        }
+
+        if (table.accept[s]) {
+            acceptToken = table.acceptToken[s];
+            acceptLen = len;
+        }
+    }
+
+    // 4. 成功匹配（Longest Match）
+    if (acceptLen > 0) {
+        std::string_view lexeme(buf.data() + pos, acceptLen);
+        Token tok{table.keywords.classify(lexeme, acceptToken),
+                  std::string(lexeme), here()};
+        pos += acceptLen;
+        return tok;
+    }
+
+    // 5. 词法错误：非法字符
+    Token tok{TokenType::ERROR, std::string(1, buf[pos]), here()};
+    pos++;  // 吃掉非法字符，防止死循环
+    return tok;
+}
+
+/*
+ * resolve
+ * =======
+ * 按窗口内的换行索引解析；窗口之前的行只需要计数和当前行首
+ * 偏移按 32 位回绕相减，窗口内的位置不受流长度影响
+ */
+LineCol StreamLexer::resolve(SourceLoc loc) const {
+    if (keepLines) {
+        return lineIndex.resolve(loc.offset);
+    }
+
+    uint32_t rel = loc.offset - (uint32_t)base;
+    const std::vector<uint32_t>& nl = windowLines.offsets();
+    size_t k = std::lower_bound(nl.begin(), nl.end(), rel) - nl.begin();
+    uint64_t start = k > 0 ? base + nl[k - 1] + 1 : lineStart;
+    return {(int)(lineBase + k + 1), (int)(base + rel - start + 1)};
+}
+
+/*
+ * fill
+ * ====
+ * 把 [pos, lim) 挪到缓冲区开头，再从 reader 读入
+ * 只有当前 token 已占满整个缓冲区时才扩容
+ * 被丢弃部分的换行计入 lineBase，窗口索引只保留挪过来的前缀
+ */
+bool StreamLexer::fill() {
+    if (eof) return false;
+
+    if (pos > 0) {
+        const std::vector<uint32_t>& nl = windowLines.offsets();
+        size_t dropped =
+            std::lower_bound(nl.begin(), nl.end(), (uint32_t)pos) - nl.begin();
+        if (dropped > 0) {
+            lineBase += dropped;
+            lineStart = base + nl[dropped - 1] + 1;
+        }
+
+        std::memmove(buf.data(), buf.data() + pos, lim - pos);
+        base += pos;
+        lim -= pos;
+        pos = 0;
+
+        windowLines = LineIndex();
+        scanNewlines(buf.data(), lim, 0, windowLines);
+    }
+    if (lim == buf.size()) {
+        // 窗口内偏移以 32 位保存
+        if (buf.size() > UINT32_MAX / 2) {
+            throw std::runtime_error("Token too large (>= 4GB)");
+        }
+        buf.resize(buf.size() * 2);
+    }
+
+    size_t got = reader(buf.data() + lim, buf.size() - lim);
+    if (got == 0) {
+        eof = true;
+        return false;
+    }
+
+    // 新读入的部分顺带记录换行位置
+    scanNewlines(buf.data() + lim, got, (uint32_t)lim, windowLines);
+    if (keepLines) {
+        if (base + lim + got > UINT32_MAX) {
+            throw std::runtime_error(
+                "Input stream too large for a full line index (>= 4GB)");
+        }
+        scanNewlines(buf.data() + lim, got, (uint32_t)(base + lim), lineIndex);
+    }
+    lim += got;
+    return true;
+}
+
+/*
+ * skipWhitespace
+ * ==============
+ * 跳过空白字符（空格 / 制表 / 换行），必要时补充输入
+ * 窗口内的部分与 Lexer 一样向量化扫描
+ */
+void StreamLexer::skipWhitespace() {
+    while (pos < lim || fill()) {
+        pos += scanBlanks(buf.data() + pos, lim - pos);
+
+        // 停在窗口内说明遇到了非空白字节
+        if (pos < lim) {
+            break;
+        }
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include "token.h"
+#include "dfa_table.h"
+#include "source_loc.h"
+
+/*
+ * StreamLexer
+ * ===========
+ * 流式词法分析器：输入不必整体驻留内存
+ *
+ * - 通过 reader 回调分块读入（stdin / socket / 超大文件）
+ * - 缓冲区有上限：每次补充数据前丢弃已消费部分，
+ *   只保留当前 token 的前缀
+ * - 跨块边界的 token 在 Longest Match 下保持完整
+ * - 流的长度不受 4GB 限制：内部以 64 位记录窗口在流中的偏移，
+ *   SourceLoc.offset 为绝对偏移的低 32 位（流不足 4GB 时即绝对偏移）
+ * - 换行索引只覆盖当前窗口，之前的行只留下计数，内存同样不随输入增长；
+ *   resolve 解析出的行列号与整体扫描（Lexer + buildLineIndex）完全一致
+ * - keepLineIndex() 之后改为保留整个流的换行索引（二进制 Token 流要写出它），
+ *   此时位置须能用 32 位表示，输入达到 4GB 时抛出异常
+ *
+ * 缓冲区会被复用，因此返回拥有文本的 Token
+ */
+class StreamLexer {
+public:
+    // 读取回调：向 buf 写入至多 cap 字节，返回实际字节数；返回 0 表示输入结束
+    using Reader = std::function<size_t(char* buf, size_t cap)>;
+
+    // bufferSize: 缓冲区初始容量；单个 token 超过容量时才会扩容
+    StreamLexer(Reader reader, const DFATable& table,
+                size_t bufferSize = 64 * 1024, uint32_t fileId = 0);
+
+    // 获取下一个 Token
+    Token nextToken();
+
+    // 位置 -> 行列号：只对最近一次 nextToken 返回的 token 有效
+    // （其所在行之前的换行已丢弃；keepLineIndex() 之后对任意位置有效）
+    LineCol resolve(SourceLoc loc) const;
+
+    // 保留整个流的换行索引；须在第一次 nextToken 之前调用
+    void keepLineIndex() { keepLines = true; }
+
+    // 整个流的换行索引（只在 keepLineIndex() 之后完整）
+    const LineIndex& lines() const { return lineIndex; }
+
+private:
+    Reader reader;
+    const DFATable& table;
+    uint32_t fileId;
+
+    std::vector<char> buf;   // 输入窗口
+    uint64_t base = 0;       // buf[0] 在整个流中的偏移
+    size_t pos = 0;          // 当前扫描位置（buf 下标）
+    size_t lim = 0;          // 有效数据末尾
+    bool eof = false;        // reader 已返回 0
+
+    LineIndex windowLines;   // 窗口内的换行（相对 buf[0] 的偏移）
+    uint64_t lineBase = 0;   // 窗口之前的换行数
+    uint64_t lineStart = 0;  // buf[0] 所在行的行首偏移
+
+    bool keepLines = false;  // 是否保留整个流的换行索引
+    LineIndex lineIndex;     // 整个流的换行索引（keepLines 时随读入增长）
+
+private:
+    // 丢弃 pos 之前的数据并补充输入；没有更多输入时返回 false
+    bool fill();
+
+    // 当前位置（绝对偏移的低 32 位）
+    SourceLoc here() const { return {(uint32_t)(base + pos), fileId}; }
+
+    // 跳过空白字符（可能跨越多个块）
+    void skipWhitespace();
+};
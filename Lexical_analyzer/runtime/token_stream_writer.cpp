@@ -0,0 +1,120 @@
+#include "token_stream_writer.h"
+
+#include <stdexcept>
+
+TokenStreamWriter::TokenStreamWriter(const std::string& filename,
+                                     const TokenKinds& kinds, uint32_t fileId)
+    : filename(filename), kinds(&kinds), out(filename, std::ios::binary | std::ios::trunc) {
+    if (!out) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+
+    std::memcpy(header.magic, TOKEN_STREAM_MAGIC, sizeof(TOKEN_STREAM_MAGIC));
+    header.version = TOKEN_STREAM_VERSION;
+    header.fileId = fileId;
+
+    // 先占位，finish() 时回填
+    out.write((const char*)&header, sizeof(header));
+}
+
+/*
+ * intern
+ * ======
+ * 相同文本只在 pool 中存一份
+ */
+uint32_t TokenStreamWriter::intern(std::string_view s) {
+    if (entries.size() * 2 >= slots.size()) {
+        rehash(slots.empty() ? 1024 : slots.size() * 2);
+    }
+
+    const size_t mask = slots.size() - 1;
+    for (size_t i = std::hash<std::string_view>{}(s) & mask; ;
+         i = (i + 1) & mask) {
+        int32_t e = slots[i];
+
+        if (e < 0) {
+            Interned added{(uint32_t)pool.size(), (uint32_t)s.size()};
+            pool.append(s);
+            slots[i] = (int32_t)entries.size();
+            entries.push_back(added);
+            return added.at;
+        }
+
+        const Interned& x = entries[e];
+        if (std::string_view(pool.data() + x.at, x.length) == s) {
+            return x.at;
+        }
+    }
+}
+
+void TokenStreamWriter::rehash(size_t capacity) {
+    slots.assign(capacity, -1);
+
+    const size_t mask = capacity - 1;
+    for (size_t e = 0; e < entries.size(); ++e) {
+        std::string_view s(pool.data() + entries[e].at, entries[e].length);
+        size_t i = std::hash<std::string_view>{}(s) & mask;
+        while (slots[i] >= 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i] = (int32_t)e;
+    }
+}
+
+/*
+ * typeOf
+ * ======
+ * TokenType -> 类型表下标（按首次出现分配）
+ */
+uint32_t TokenStreamWriter::typeOf(TokenType type) {
+    size_t k = (size_t)type;
+    if (k >= typeIndex.size()) {
+        typeIndex.resize(k + 1, -1);
+    }
+
+    if (typeIndex[k] < 0) {
+        const std::string& name = kinds->name(type);
+        typeIndex[k] = (int)types.size();
+        types.push_back({intern(name), (uint32_t)name.size()});
+    }
+    return (uint32_t)typeIndex[k];
+}
+
+void TokenStreamWriter::write(TokenType type, std::string_view lexeme,
+                              uint32_t offset) {
+    TokenRecord r;
+    r.type = typeOf(type);
+    r.offset = offset;
+    r.lexeme = intern(lexeme);
+    r.length = (uint32_t)lexeme.size();
+
+    out.write((const char*)&r, sizeof(r));
+    header.tokenCount++;
+}
+
+void TokenStreamWriter::finish(const LineIndex& lines) {
+    const std::vector<uint32_t>& newlines = lines.offsets();
+
+    header.typeCount = (uint32_t)types.size();
+    header.newlineCount = (uint32_t)newlines.size();
+    header.poolSize = (uint32_t)pool.size();
+
+    out.write((const char*)types.data(), types.size() * sizeof(TokenTypeEntry));
+    out.write((const char*)newlines.data(), newlines.size() * sizeof(uint32_t));
+    out.write(pool.data(), pool.size());
+
+    out.seekp(0);
+    out.write((const char*)&header, sizeof(header));
+    out.flush();
+
+    if (!out) {
+        throw std::runtime_error("Cannot write file: " + filename);
+    }
+}
+
+void TokenStreamWriter::fail(std::string_view message) {
+    out.close();
+    out.open(filename, std::ios::binary | std::ios::trunc);
+    out.write(message.data(), message.size());
+    out.flush();
+}
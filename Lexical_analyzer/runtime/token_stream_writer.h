@@ -0,0 +1,63 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "token.h"
+#include "token_stream.h"
+
+/*
+ * TokenStreamWriter
+ * =================
+ * 以二进制 Token 流格式（token_stream.h）写出 Lexer 的结果
+ *
+ * - 定长记录边扫描边写入文件
+ * - lexeme 与类型名驻留在内存中的 pool 里（只随不同文本的个数增长），
+ *   finish() 时连同类型表、换行表一起写在记录之后，再回填文件头
+ * - 出错时 fail() 截断文件，只写文本报错信息（与文本输出一致）
+ */
+class TokenStreamWriter {
+public:
+    // filename: 输出文件（截断后重写）
+    // kinds:    Token 名称表（由规则文件定义，须比 TokenStreamWriter 活得久）
+    // fileId:   写入文件头的 SourceLoc::fileId
+    TokenStreamWriter(const std::string& filename, const TokenKinds& kinds,
+                      uint32_t fileId = 0);
+
+    TokenStreamWriter(const TokenStreamWriter&) = delete;
+    TokenStreamWriter& operator=(const TokenStreamWriter&) = delete;
+
+    // 追加一个 token
+    void write(TokenType type, std::string_view lexeme, uint32_t offset);
+
+    // 写出各表与文件头；lines 为源码的换行索引
+    void finish(const LineIndex& lines);
+
+    // 丢弃已输出的全部内容，改为只写 message
+    void fail(std::string_view message);
+
+private:
+    std::string filename;
+    const TokenKinds* kinds;
+    std::ofstream out;
+    TokenStreamHeader header{};
+
+    // 驻留文本：开放寻址散列表，槽位存 entries 下标（-1 为空），
+    // 键直接与 pool 中的文本比较，查找时不构造 std::string
+    struct Interned {
+        uint32_t at;
+        uint32_t length;
+    };
+    std::string pool;
+    std::vector<Interned> entries;
+    std::vector<int32_t> slots;
+
+    std::vector<TokenTypeEntry> types;                 // 类型表
+    std::vector<int> typeIndex;                        // TokenType -> 类型表下标
+
+private:
+    uint32_t intern(std::string_view s);
+    void rehash(size_t capacity);
+    uint32_t typeOf(TokenType type);
+};
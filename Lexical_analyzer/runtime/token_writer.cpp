@@ -0,0 +1,123 @@
+#include "token_writer.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/*
+ * 平台差异：Win32 CRT 的底层 I/O 函数带下划线前缀
+ */
+#ifdef _WIN32
+static int openFile(const char* name) {
+    return ::_open(name, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+}
+static long writeFile(int fd, const char* p, size_t n) {
+    return ::_write(fd, p, (unsigned)std::min<size_t>(n, 1u << 30));
+}
+static void closeFile(int fd) { ::_close(fd); }
+#else
+static int openFile(const char* name) {
+    return ::open(name, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+}
+static long writeFile(int fd, const char* p, size_t n) {
+    return (long)::write(fd, p, n);
+}
+static void closeFile(int fd) { ::close(fd); }
+#endif
+
+TokenWriter::TokenWriter(const std::string& filename, const TokenKinds& kinds,
+                         size_t bufferSize)
+    : filename(filename), kinds(&kinds), buf(bufferSize < 64 ? 64 : bufferSize) {
+    open();
+}
+
+TokenWriter::~TokenWriter() {
+    try {
+        flush();
+    }
+    catch (const std::exception&) {
+    }
+    closeFile(fd);
+}
+
+/*
+ * 打开（并截断）输出文件
+ */
+void TokenWriter::open() {
+    if (fd >= 0) {
+        closeFile(fd);
+    }
+    fd = openFile(filename.c_str());
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open file: " + filename);
+    }
+}
+
+void TokenWriter::writeAll(const char* p, size_t n) {
+    while (n > 0) {
+        long got = writeFile(fd, p, n);
+        if (got <= 0) {
+            throw std::runtime_error("Cannot write file: " + filename);
+        }
+        p += got;
+        n -= (size_t)got;
+    }
+}
+
+void TokenWriter::flush() {
+    writeAll(buf.data(), used);
+    used = 0;
+}
+
+/*
+ * append
+ * ======
+ * 放不下时先写出缓冲区；超过整个缓冲区的长文本直接写出
+ */
+void TokenWriter::append(std::string_view s) {
+    if (s.size() > buf.size() - used) {
+        flush();
+        if (s.size() > buf.size()) {
+            writeAll(s.data(), s.size());
+            return;
+        }
+    }
+    std::memcpy(buf.data() + used, s.data(), s.size());
+    used += s.size();
+}
+
+void TokenWriter::appendInt(int v) {
+    char tmp[16];
+    auto res = std::to_chars(tmp, tmp + sizeof(tmp), v);
+    append(std::string_view(tmp, (size_t)(res.ptr - tmp)));
+}
+
+void TokenWriter::write(TokenType type, std::string_view lexeme, LineCol lc) {
+    append(kinds->name(type));
+
+    if (!lexeme.empty()) {
+        append(" : ");
+        append(lexeme);
+    }
+
+    append(" (");
+    appendInt(lc.line);
+    append(",");
+    appendInt(lc.column);
+    append(")\n");
+}
+
+void TokenWriter::fail(std::string_view message) {
+    used = 0;
+    open();
+    append(message);
+    flush();
+}
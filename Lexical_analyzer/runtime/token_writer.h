@@ -0,0 +1,54 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include "token.h"
+
+/*
+ * TokenWriter
+ * ===========
+ * lexer_gen 的文本输出阶段：每个 token 一行
+ *
+ *   NAME : lexeme (line,column)
+ *   NAME (line,column)            （lexeme 为空时）
+ *
+ * - 用 std::to_chars 格式化进固定大小的缓冲区，写满即整块 write(2)
+ * - 内存占用与输入大小无关，结果边扫描边落盘
+ * - 出错时 fail() 截断文件，只留下错误信息（与原先只输出报错的行为一致）
+ */
+class TokenWriter {
+public:
+    // filename:   输出文件（截断后重写）
+    // kinds:      Token 名称表（由规则文件定义，须比 TokenWriter 活得久）
+    // bufferSize: 缓冲区大小
+    TokenWriter(const std::string& filename, const TokenKinds& kinds,
+                size_t bufferSize = 1 << 16);
+    ~TokenWriter();
+
+    TokenWriter(const TokenWriter&) = delete;
+    TokenWriter& operator=(const TokenWriter&) = delete;
+
+    // 追加一个 token
+    void write(TokenType type, std::string_view lexeme, LineCol lc);
+
+    // 丢弃已输出的全部内容，改为只写 message
+    void fail(std::string_view message);
+
+    // 写出缓冲区中的内容
+    void flush();
+
+private:
+    std::string filename;
+    const TokenKinds* kinds;
+    int fd = -1;
+    std::vector<char> buf;
+    size_t used = 0;
+
+private:
+    void open();
+    void writeAll(const char* p, size_t n);
+
+    void append(std::string_view s);
+    void appendInt(int v);
+};
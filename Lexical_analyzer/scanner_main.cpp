@@ -0,0 +1,89 @@
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "token.h"
+#include "source_file.h"
+
+/*
+ * STATIC_LEXER：使用 --emit-table 生成的编译期转移表 + StaticLexer 模板
+ * 否则：使用 --emit-scanner 生成的直接编码扫描器
+ */
+#ifdef STATIC_LEXER
+#include "static_lexer.h"
+#include "generated_rules.h"
+using GeneratedScanner = StaticLexer<GeneratedRules>;
+#else
+#include "generated_scanner.h"
+using GeneratedScanner = GeneratedLexer;
+#endif
+
+/*
+ * 预生成扫描器的驱动程序
+ * ======================
+ * 与 lexer_gen 输出格式相同，但扫描器由 lexer_gen 预先生成，
+ * 运行时不再构造 NFA / DFA，也不链接 automata/ 下的代码
+ *
+ * 用法：scanner <source_file>（static_scanner 相同）
+ */
+int main(int argc, char* argv[]) {
+    try {
+        if (argc < 2) {
+            std::ofstream ofs("output.txt");
+            ofs << "Usage: scanner <source_file>\n";
+            return 1;
+        }
+
+        SourceFile code(argv[1]);
+        std::string_view src = code.view();
+
+        // 换行索引：只在打印位置时使用
+        LineIndex lines;
+        for (const char* p = src.data(), *end = p + src.size();
+             (p = (const char*)std::memchr(p, '\n', end - p)) != nullptr; ++p) {
+            lines.addNewline((uint32_t)(p - src.data()));
+        }
+
+        GeneratedScanner lexer(src);
+        std::ostringstream output;
+
+        while (true) {
+            TokenView tok = lexer.nextTokenView();
+            LineCol lc = lines.resolve(tok.loc.offset);
+
+            if (tok.type == TokenType::ERROR) {
+                std::ofstream ofs("output.txt");
+                ofs << "Lexical Error: illegal character '"
+                    << tok.lexeme << "'\n"
+                    << "at line " << lc.line
+                    << ", column " << lc.column << "\n";
+                return 1;
+            }
+
+            output << GeneratedScanner::tokenName(tok.type);
+
+            if (!tok.lexeme.empty()) {
+                output << " : " << tok.lexeme;
+            }
+
+            output << " (" << lc.line << "," << lc.column << ")";
+            output << "\n";
+
+            if (tok.type == TokenType::ENDFILE) {
+                break;
+            }
+        }
+
+        std::ofstream ofs("output.txt");
+        ofs << output.str();
+    }
+    catch (const std::exception& e) {
+        std::ofstream ofs("output.txt");
+        ofs << "Fatal Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,41 @@
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include "static_lexer.h"
+#include "generated_rules.h"
+
+/*
+ * StaticLexer 编译期自检
+ * ======================
+ * make check 对每个规则集生成 generated_rules.h，再以 -fsyntax-only 编译本文件：
+ * 规则集中的每个字面量单独扫描时，都须在常量表达式中整体识别为它自己的种类
+ * （含 --keyword-hash 的关键字归类）
+ *
+ * match / classify 任何一处不能在编译期求值，或结果不符，编译都会失败
+ */
+using CheckedLexer = StaticLexer<GeneratedRules>;
+
+// 第 k 种 Token 的字面量（若有）恰好扫描出一个该种类的 token
+constexpr bool literalLexesToItsKind(size_t k) {
+    std::string_view literal = GeneratedRules::tokenLiterals[k];
+    if (literal.empty()) {
+        return true;
+    }
+
+    CheckedLexer lexer(literal);
+    TokenView tok = lexer.nextTokenView();
+    return tok.type == (TokenType)k && tok.lexeme == literal &&
+           lexer.nextTokenView().type == TokenType::ENDFILE;
+}
+
+constexpr bool everyLiteralLexesToItsKind() {
+    for (size_t k = 0; k < std::size(GeneratedRules::tokenLiterals); ++k) {
+        if (!literalLexesToItsKind(k)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static_assert(everyLiteralLexesToItsKind(),
+              "StaticLexer must lex every literal rule to its own kind at compile time");
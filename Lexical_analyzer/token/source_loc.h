@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/*
+ * SourceLoc
+ * =========
+ * 紧凑的源码位置：32 位字节偏移 + 文件编号
+ *
+ * Lexer / Parser 都只传递 SourceLoc，
+ * 行列号不随 token 保存，需要打印时再由 LineIndex 解析
+ */
+struct SourceLoc {
+    uint32_t offset = 0;   // 文件内字节偏移
+    uint32_t fileId = 0;   // 文件编号
+};
+
+/*
+ * LineCol
+ * =======
+ * 解析后的行列号（均从 1 开始）
+ */
+struct LineCol {
+    int line;
+    int column;
+};
+
+/*
+ * LineIndex
+ * =========
+ * 一个文件的换行索引：按升序保存每个 '\n' 的字节偏移
+ *
+ * - 建立：Lexer 侧由 buildLineIndex / scanNewlines 向量化扫描
+ * - 解析：二分查找，偏移 -> 行列号
+ */
+class LineIndex {
+public:
+    // 追加一个换行（偏移必须递增）
+    void addNewline(uint32_t offset) { newlines.push_back(offset); }
+
+    // 换行个数
+    size_t size() const { return newlines.size(); }
+
+    // 全部换行偏移（升序）
+    const std::vector<uint32_t>& offsets() const { return newlines; }
+
+    // 偏移 -> 行列号
+    LineCol resolve(uint32_t offset) const {
+        auto it = std::lower_bound(newlines.begin(), newlines.end(), offset);
+        int line = (int)(it - newlines.begin()) + 1;
+        uint32_t lineStart = (it == newlines.begin()) ? 0 : *(it - 1) + 1;
+        return {line, (int)(offset - lineStart) + 1};
+    }
+
+private:
+    std::vector<uint32_t> newlines;
+};
@@ -1,57 +1,23 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
+#include "source_loc.h"
 #include <stdexcept>
 
 
 /*
  * TokenType
  * =========
- * 类 C 语言「最小可编译子集」的核心 Token 集
- * Lexer / Parser / IR / CodeGen 都依赖这里
+ * Token 种类的稠密整数编号
+ *
+ * 种类由 .lex 规则文件定义（见 TokenKinds），这里只固定两个保留编号；
+ * 其余编号在生成时按规则文件分配，Lexer 到 Parser 之间只传这个整数
  */
-enum class TokenType {
-    // ===== 控制 / 结束 =====
-    ENDFILE,        // 文件结束
-    ERROR,      // 词法错误
-
-    // ===== Tiny 专用 =====
-    READ,
-    WRITE,
-
-    // ===== 标识符 & 常量 =====
-    ID,         // 标识符
-    NUM,        // 整数常量
-
-    // ===== 关键字 =====
-    INT,     // int
-    VOID,    // void
-    IF,      // if
-    ELSE,    // else
-    WHILE,   // while
-    RETURN,  // return
-
-    // ===== 运算符 =====
-    ASSIGN,     // =
-    PLUS,       // +
-    MINUS,      // -
-    MULT,        // *
-    DIV,        // /
-
-    // ===== 关系运算符 =====
-    LT,         // <
-    GT,         // >
-    LTE,         // <=
-    GTE,         // >=
-    EQ,         // ==
-    NEQ,         // !=
-
-    // ===== 界符 =====
-    LPAREN,         // (
-    RPAREN,         // )
-    LBRACE,     // {
-    RBRACE,     // }
-    SEMI,  // ;
-    COMMA       // ,
+enum class TokenType : uint16_t {
+    ENDFILE = 0,    // 文件结束
+    ERROR = 1       // 词法错误
 };
 
 /*
@@ -62,133 +28,100 @@ enum class TokenType {
 struct Token {
     TokenType type;
     std::string lexeme; // 原始字符串（用于符号表 / 报错）
-    int line;
-    int column;
+    SourceLoc loc;      // 起始位置（行列号由 LineIndex 按需解析）
 };
 
-inline int tokenPriority(TokenType t) {
-    switch (t) {
-        // ===== 关键字（最高优先级）=====
-        case TokenType::INT:
-        case TokenType::VOID:
-        case TokenType::IF:
-        case TokenType::ELSE:
-        case TokenType::WHILE:
-        case TokenType::RETURN:
-        case TokenType::WRITE:
-        case TokenType::READ:
-            return 1;
-
-        // ===== 标识符 =====
-        case TokenType::ID:
-            return 2;
-
-        // ===== 常量 =====
-        case TokenType::NUM:
-            return 3;
-
-        // ===== 其他 =====
-        default:
-            return 10;
-    }
-}
-
-
 /*
- * tokenName
+ * TokenView
  * =========
- * 调试 / 打印用，不参与语义
+ * 零拷贝的 Token：lexeme 直接指向源码缓冲区
+ *
+ * 注意：
+ * - 源码缓冲区必须比 TokenView 活得久
+ * - 需要长期保存文本时再用 toToken() 转换
  */
-inline std::string tokenName(TokenType t) {
-    switch (t) {
-        case TokenType::ENDFILE:        return "ENDFILE";
-        case TokenType::ERROR:      return "ERROR";
-
-        case TokenType::ID:         return "ID";
-        case TokenType::NUM:        return "NUM";
-
-        case TokenType::INT:     return "INT";
-        case TokenType::VOID:    return "VOID";
-        case TokenType::IF:      return "IF";
-        case TokenType::ELSE:    return "ELSE";
-        case TokenType::WHILE:   return "WHILE";
-        case TokenType::RETURN:  return "RETURN";
-
-        case TokenType::ASSIGN:     return "ASSIGN";
-        case TokenType::PLUS:       return "PLUS";
-        case TokenType::MINUS:      return "MINUS";
-        case TokenType::MULT:        return "MULT";
-        case TokenType::DIV:        return "DIV";
-
-        case TokenType::LT:         return "LT";
-        case TokenType::GT:         return "GT";
-        case TokenType::LTE:         return "LTE";
-        case TokenType::GTE:         return "GTE";
-        case TokenType::EQ:         return "EQ";
-        case TokenType::NEQ:         return "NEQ";
+struct TokenView {
+    TokenType type;
+    std::string_view lexeme;
+    SourceLoc loc;
 
-        case TokenType::LPAREN:         return "LPAREN";
-        case TokenType::RPAREN:         return "RPAREN";
-        case TokenType::LBRACE:     return "LBRACE";
-        case TokenType::RBRACE:     return "RBRACE";
-        case TokenType::SEMI:  return "SEMI";
-        case TokenType::COMMA:      return "COMMA";
-        case TokenType::READ:      return "READ";
-        case TokenType::WRITE:      return "WRITE";
+    // 按需转换为拥有文本的 Token
+    Token toToken() const {
+        return {type, std::string(lexeme), loc};
     }
-    return "UNKNOWN";
-}
-
+};
 
 /*
- * tokenFromString
- * ===============
- * 将规则文件中的 Token 名称映射为 TokenType
- * 用于 Lexer Generator
+ * TokenBatch
+ * ==========
+ * 批量 Token 的结构数组（SoA）缓冲区
+ *
+ * - 由调用者持有并反复复用，容量在构造时确定
+ * - 第 i 个 token 的文本为 src.substr(offset[i], length[i])
+ * - 第 i 个 token 的位置为 SourceLoc{offset[i], fileId}
+ * - count 为最近一次填充的 token 数
  */
-inline TokenType tokenFromString(const std::string& s) {
-    // ===== 控制 / 结束 =====
-    if (s == "ENDFILE") return TokenType::ENDFILE;
-    if (s == "ERROR")   return TokenType::ERROR;
+struct TokenBatch {
+    std::vector<TokenType> type;
+    std::vector<uint32_t> offset;
+    std::vector<uint32_t> length;
+    uint32_t fileId = 0;
+    size_t count = 0;
 
-    // ===== 标识符 & 常量 =====
-    if (s == "ID")  return TokenType::ID;
-    if (s == "NUM") return TokenType::NUM;
+    explicit TokenBatch(size_t capacity = 1024)
+        : type(capacity), offset(capacity), length(capacity) {}
 
-    // ===== 关键字 =====
-    if (s == "INT")    return TokenType::INT;
-    if (s == "VOID")   return TokenType::VOID;
-    if (s == "IF")     return TokenType::IF;
-    if (s == "ELSE")   return TokenType::ELSE;
-    if (s == "WHILE")  return TokenType::WHILE;
-    if (s == "RETURN") return TokenType::RETURN;
-
-    // ===== 运算符 =====
-    if (s == "ASSIGN") return TokenType::ASSIGN;
-    if (s == "PLUS")   return TokenType::PLUS;
-    if (s == "MINUS")  return TokenType::MINUS;
-    if (s == "MULT")   return TokenType::MULT;
-    if (s == "DIV")    return TokenType::DIV;
-
-    // ===== 关系运算符 =====
-    if (s == "LT")  return TokenType::LT;
-    if (s == "GT")  return TokenType::GT;
-    if (s == "LTE") return TokenType::LTE;
-    if (s == "GTE") return TokenType::GTE;
-    if (s == "EQ")  return TokenType::EQ;
-    if (s == "NEQ") return TokenType::NEQ;
-
-    // ===== 界符 =====
-    if (s == "LPAREN") return TokenType::LPAREN;
-    if (s == "RPAREN") return TokenType::RPAREN;
-    if (s == "LBRACE") return TokenType::LBRACE;
-    if (s == "RBRACE") return TokenType::RBRACE;
-    if (s == "SEMI")   return TokenType::SEMI;
-    if (s == "COMMA")  return TokenType::COMMA;
+    size_t capacity() const { return type.size(); }
+};
 
-    if (s == "READ")  return TokenType::READ;
-    if (s == "WRITE") return TokenType::WRITE;
+/*
+ * TokenKinds
+ * ==========
+ * 一个规则集的 Token 种类表：名称 <-> 编号
+ *
+ * - 0 / 1 固定为 ENDFILE / ERROR，规则中的名称按首次出现的顺序从 2 起编号
+ * - literal：只由一条字面量规则定义的种类记下该字面量（如 "+"、"while"），
+ *   否则为空（{ID} / {NUM} / 正则 / 多条规则）；语法分析器据此绑定终结符
+ */
+struct TokenKinds {
+    std::vector<std::string> names{"ENDFILE", "ERROR"};
+    std::vector<std::string> literals{"", ""};
+
+    size_t size() const { return names.size(); }
+
+    const std::string& name(TokenType t) const { return names[(size_t)t]; }
+    const std::string& literal(TokenType t) const { return literals[(size_t)t]; }
+
+    // 按名称查找；不存在时返回 false
+    bool find(const std::string& s, TokenType& t) const {
+        for (size_t k = 0; k < names.size(); ++k) {
+            if (names[k] == s) {
+                t = (TokenType)k;
+                return true;
+            }
+        }
+        return false;
+    }
 
+    // 登记一个名称，已存在时返回原编号
+    TokenType intern(const std::string& s) {
+        TokenType t;
+        if (find(s, t)) return t;
+        if (names.size() > UINT16_MAX) {
+            throw std::runtime_error("Too many token kinds");
+        }
+        names.push_back(s);
+        literals.emplace_back();
+        return (TokenType)(names.size() - 1);
+    }
+};
 
-    throw std::runtime_error("Unknown token name: " + s);
+/*
+ * tokenPriority
+ * =============
+ * 同一 lexeme 被多条规则接受时取值小者：编号即优先级，
+ * 规则文件中先出现的种类胜出（关键字应写在 {ID} 之前，否则生成时警告）
+ */
+inline int tokenPriority(TokenType t) {
+    return (int)t;
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/*
+ * 二进制 Token 流格式
+ * ==================
+ * Lexer 与 Parser 之间的紧凑交换格式（lexer_gen --format=binary），
+ * Parser 映射文件后按下标直接读取，不再逐行解析文本
+ *
+ * 布局（各段按 4 字节对齐，本机字节序）：
+ *
+ *   TokenStreamHeader
+ *   TokenRecord    records[tokenCount]    定长记录
+ *   TokenTypeEntry types[typeCount]       类型编号 -> 名称
+ *   uint32_t       newlines[newlineCount] 换行偏移（重建 LineIndex）
+ *   char           pool[poolSize]         驻留的 lexeme / 类型名，相同文本只存一份
+ *
+ * 类型编号由写入方按首次出现的顺序分配，名称写在类型表里，
+ * 读取方不依赖 TokenType 的枚举值
+ */
+
+constexpr char TOKEN_STREAM_MAGIC[8] = {'L', 'X', 'T', 'O', 'K', 'E', 'N', 'S'};
+
+// 格式版本：布局变化时递增
+constexpr uint32_t TOKEN_STREAM_VERSION = 1;
+
+struct TokenStreamHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t fileId;        // SourceLoc::fileId
+    uint32_t tokenCount;
+    uint32_t typeCount;
+    uint32_t newlineCount;
+    uint32_t poolSize;
+};
+
+struct TokenRecord {
+    uint32_t type;          // 类型表下标
+    uint32_t offset;        // 源码中的字节偏移（SourceLoc::offset）
+    uint32_t lexeme;        // pool 中的起点
+    uint32_t length;        // lexeme 长度
+};
+
+struct TokenTypeEntry {
+    uint32_t name;          // pool 中的起点
+    uint32_t length;        // 名称长度
+};
+
+/*
+ * TokenStreamView
+ * ===============
+ * 对一段内存（通常是映射的文件）中的 Token 流做校验并按段切分
+ * 不拷贝数据；内存必须比 TokenStreamView 活得久
+ */
+struct TokenStreamView {
+    const TokenStreamHeader* header = nullptr;
+    const TokenRecord* records = nullptr;
+    const TokenTypeEntry* types = nullptr;
+    const uint32_t* newlines = nullptr;
+    const char* pool = nullptr;
+
+    // 是否以二进制 Token 流的魔数开头
+    static bool isTokenStream(std::string_view bytes) {
+        return bytes.size() >= sizeof(TOKEN_STREAM_MAGIC) &&
+               std::memcmp(bytes.data(), TOKEN_STREAM_MAGIC,
+                           sizeof(TOKEN_STREAM_MAGIC)) == 0;
+    }
+
+    // 切分各段；版本不符、长度不符或下标越界时返回 false
+    bool open(std::string_view bytes) {
+        if (!isTokenStream(bytes) || bytes.size() < sizeof(TokenStreamHeader) ||
+            (uintptr_t)bytes.data() % alignof(TokenStreamHeader) != 0) {
+            return false;
+        }
+
+        const TokenStreamHeader* h = (const TokenStreamHeader*)bytes.data();
+        if (h->version != TOKEN_STREAM_VERSION) {
+            return false;
+        }
+
+        uint64_t expect = sizeof(TokenStreamHeader) +
+                          (uint64_t)h->tokenCount * sizeof(TokenRecord) +
+                          (uint64_t)h->typeCount * sizeof(TokenTypeEntry) +
+                          (uint64_t)h->newlineCount * sizeof(uint32_t) +
+                          h->poolSize;
+        if (expect != bytes.size()) {
+            return false;
+        }
+
+        const char* p = bytes.data() + sizeof(TokenStreamHeader);
+        records = (const TokenRecord*)p;
+        p += (size_t)h->tokenCount * sizeof(TokenRecord);
+        types = (const TokenTypeEntry*)p;
+        p += (size_t)h->typeCount * sizeof(TokenTypeEntry);
+        newlines = (const uint32_t*)p;
+        p += (size_t)h->newlineCount * sizeof(uint32_t);
+        pool = p;
+
+        for (uint32_t k = 0; k < h->typeCount; ++k) {
+            if ((uint64_t)types[k].name + types[k].length > h->poolSize) {
+                return false;
+            }
+        }
+        for (uint32_t k = 0; k < h->tokenCount; ++k) {
+            if (records[k].type >= h->typeCount ||
+                (uint64_t)records[k].lexeme + records[k].length > h->poolSize) {
+                return false;
+            }
+        }
+
+        header = h;
+        return true;
+    }
+
+    uint32_t size() const { return header->tokenCount; }
+
+    std::string_view typeName(uint32_t type) const {
+        return {pool + types[type].name, types[type].length};
+    }
+
+    std::string_view lexeme(const TokenRecord& r) const {
+        return {pool + r.lexeme, r.length};
+    }
+};
@@ -9,6 +9,8 @@
 #include <string>
 #include <vector>
 
+#include "../Lexical_analyzer/token/source_loc.h"
+
 using namespace std;
 
 // ﷨ţսս
@@ -17,11 +19,12 @@ struct GrammarSymbol
 	string Name;	  // 
 	bool IsTerminal;  // ǷΪս
 	string TokenType; // Token
-	string Position;  // λ
+	SourceLoc Loc;    // λãֽƫ + ļţкŰ
+	int Id;           // űţSLR кţսΪ ACTION СսΪ GOTO У-1 ʾδ
 
 	// 캯
-	GrammarSymbol(const string& name = "", bool isTerminal = false, const string& tokenType = "", const string& position = "")
-		: Name(name), IsTerminal(isTerminal), TokenType(tokenType), Position(position)
+	GrammarSymbol(const string& name = "", bool isTerminal = false, const string& tokenType = "", SourceLoc loc = SourceLoc(), int id = -1)
+		: Name(name), IsTerminal(isTerminal), TokenType(tokenType), Loc(loc), Id(id)
 	{
 	}
 
@@ -5,10 +5,12 @@
 #include "GrammarLoader.hpp"
 #include "LRAutomaton.hpp"
 #include "LRItem.hpp"
+#include <cctype>
 #include <iostream>
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 
 using namespace std;
 
@@ -68,6 +70,24 @@ struct SLRAnalysisTableBuilder
 	// GOTO״̬  ս  ״̬
 	map<pair<int, GrammarSymbol>, int> GotoTable;
 
+	// ŵĳܱűչ﷨ʱֻ±
+	// ս Grammar.Terminals ˳ţ$ 󣻷ս Grammar.NonTerminals ˳
+	map<string, int> TerminalIds;
+	map<string, int> NonTerminalIds;
+	vector<string> TerminalNames;
+	vector<string> NonTerminalNames;
+	int EndTerminal = -1;	   // $ ı
+	int StartNonTerminal = -1; // 㿪ʼŵı
+
+	size_t StateCount = 0;
+	vector<SLRAction> DenseAction; // [״̬ * ս + ս]
+	vector<int> DenseGoto;		   // [״̬ * ս + ս]-1 Ϊ
+
+	vector<int> ProductionIndex; // ʽ  Grammar.Productions ±
+	vector<int> ProductionLeft;	 // ʽ  󲿷ս
+	// ʽ  ҲűţսΪţսΪ ս + 
+	vector<vector<int>> ProductionRight;
+
 	// 캯
 	SLRAnalysisTableBuilder(const LRAutomatonBuilder &automatonBuilder,
 							const FirstFollowCalculator &ffCalculator)
@@ -83,6 +103,7 @@ struct SLRAnalysisTableBuilder
 	{
 		BuildActionTable();
 		BuildGotoTable();
+		BuildDenseTable();
 	}
 
 	// ACTION
@@ -198,6 +219,136 @@ struct SLRAnalysisTableBuilder
 		}
 	}
 
+	// ܱΪűţٰ ACTION / GOTO չɰ״̬е
+	void BuildDenseTable()
+	{
+		for (const GrammarSymbol &Term : Grammar.Terminals)
+		{
+			if (TerminalIds.emplace(Term.Name, (int)TerminalNames.size()).second)
+			{
+				TerminalNames.push_back(Term.Name);
+			}
+		}
+		EndTerminal = (int)TerminalNames.size();
+		TerminalIds[FFCalculator.EndSymbol.Name] = EndTerminal;
+		TerminalNames.push_back(FFCalculator.EndSymbol.Name);
+
+		for (const GrammarSymbol &NonTerm : Grammar.NonTerminals)
+		{
+			if (NonTerminalIds.emplace(NonTerm.Name, (int)NonTerminalNames.size()).second)
+			{
+				NonTerminalNames.push_back(NonTerm.Name);
+			}
+		}
+		StartNonTerminal = NonTerminalIdOf(Grammar.StartSymbol.Name);
+
+		StateCount = AutomatonBuilder.States.size();
+		DenseAction.assign(StateCount * TerminalNames.size(), SLRAction());
+		for (const auto &Entry : ActionTable)
+		{
+			auto It = TerminalIds.find(Entry.first.second.Name);
+			if (Entry.first.second.IsTerminal && It != TerminalIds.end())
+			{
+				DenseAction[Entry.first.first * TerminalNames.size() + It->second] = Entry.second;
+			}
+		}
+
+		DenseGoto.assign(StateCount * NonTerminalIds.size(), -1);
+		for (const auto &Entry : GotoTable)
+		{
+			auto It = NonTerminalIds.find(Entry.first.second.Name);
+			if (It != NonTerminalIds.end())
+			{
+				DenseGoto[Entry.first.first * NonTerminalIds.size() + It->second] = Entry.second;
+			}
+		}
+
+		for (size_t i = 0; i < Grammar.Productions.size(); i++)
+		{
+			const Production &Prod = Grammar.Productions[i];
+			if (Prod.Id < 0)
+			{
+				continue;
+			}
+			if (Prod.Id >= (int)ProductionIndex.size())
+			{
+				ProductionIndex.resize(Prod.Id + 1, -1);
+				ProductionLeft.resize(Prod.Id + 1, -1);
+				ProductionRight.resize(Prod.Id + 1);
+			}
+			if (ProductionIndex[Prod.Id] == -1)
+			{
+				ProductionIndex[Prod.Id] = (int)i;
+				ProductionLeft[Prod.Id] = NonTerminalIdOf(Prod.Left.Name);
+				for (const GrammarSymbol &Symbol : Prod.Right)
+				{
+					int Id = Symbol.IsTerminal ? TerminalIdOf(Symbol.Name) : NonTerminalIdOf(Symbol.Name);
+					ProductionRight[Prod.Id].push_back(Symbol.IsTerminal || Id == -1 ? Id : (int)TerminalNames.size() + Id);
+				}
+			}
+		}
+	}
+
+	// ս  ţսʱ -1
+	int TerminalIdOf(const string &Name) const
+	{
+		auto It = TerminalIds.find(Name);
+		return It != TerminalIds.end() ? It->second : -1;
+	}
+
+	// ս  ţǷսʱ -1
+	int NonTerminalIdOf(const string &Name) const
+	{
+		auto It = NonTerminalIds.find(Name);
+		return It != NonTerminalIds.end() ? It->second : -1;
+	}
+
+	// һ token 󶨵սȰСдID  idIF  if
+	// ٰ token ı"+"";"սʱ -1
+	int ResolveTerminal(const string &KindName, const string &Text) const
+	{
+		string Lower = KindName;
+		for (char &c : Lower)
+		{
+			c = (char)tolower((unsigned char)c);
+		}
+		int Id = TerminalIdOf(Lower);
+		return Id != -1 ? Id : TerminalIdOf(Text);
+	}
+
+	// ʷ Token һ԰սnames / literals  TokenType Ϊ±꣬
+	// ֵͬ TokenType Ϊ±ꣻ޷󶨵Ϊ -1 token ʱ
+	vector<int> BindTokenKinds(const vector<string> &Names, const vector<string> &Literals) const
+	{
+		vector<int> Result(Names.size(), -1);
+		for (size_t k = 0; k < Names.size(); k++)
+		{
+			Result[k] = ResolveTerminal(Names[k], k < Literals.size() ? Literals[k] : "");
+		}
+		return Result;
+	}
+
+	// ȡACTIONսţ
+	const SLRAction &GetAction(int StateId, int TerminalId) const
+	{
+		static SLRAction ErrorAction;
+		if (StateId < 0 || (size_t)StateId >= StateCount || TerminalId < 0 || TerminalId >= (int)TerminalNames.size())
+		{
+			return ErrorAction;
+		}
+		return DenseAction[StateId * TerminalNames.size() + TerminalId];
+	}
+
+	// ȡGOTOսţ
+	int GetGoto(int StateId, int NonTerminalId) const
+	{
+		if (StateId < 0 || (size_t)StateId >= StateCount || NonTerminalId < 0 || NonTerminalId >= (int)NonTerminalIds.size())
+		{
+			return -1;
+		}
+		return DenseGoto[StateId * NonTerminalIds.size() + NonTerminalId];
+	}
+
 	// ȡACTION
 	const SLRAction &GetAction(int StateId, const GrammarSymbol &Symbol) const
 	{
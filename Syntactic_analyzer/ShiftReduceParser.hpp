@@ -3,7 +3,10 @@
 
 #include "GrammarLoader.hpp"
 #include "SLRAnalysisTable.hpp"
+#include "../Lexical_analyzer/runtime/source_file.h"
+#include "../Lexical_analyzer/token/token_stream.h"
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <sstream>
 #include <stack>
@@ -108,9 +111,9 @@ struct ShiftReduceParser
 	// TypeValڷս Type ۺԣ "int" / "void"
 	struct TypeVal { BaseType t = BaseType::ERR; };
 	// IdValս id ֵ
-	// - nameԭʼ lexeme "x" LookupSymbol.Nameǻᱻĳ "id"
-	// - posλϢڱλ
-	struct IdVal { string name, pos; };
+	// - nameԭʼ lexeme "x"ջֻսţӡΪ "id"
+	// - posλϢڱλӡʱ FormatLoc Ϊкţ
+	struct IdVal { string name; SourceLoc pos; };
 	// NumValս num ֵͳֵ
 	struct NumVal { int v = 0; };
 	/*
@@ -147,7 +150,7 @@ struct ShiftReduceParser
 	using SemVal = variant<monostate, TypeVal, IdVal, NumVal, ExprVal, BoolVal, StmtVal, OpVal>;
 	/*
 	ValueStackֵջ SymbolStack ͬǳҪ
-	- SHIFTѹսӦֵid/num/type/opԼջѹ LookupSymbol
+	- SHIFTѹսӦֵid/num/type/opջѹŶ
 	- REDUCE RHS ֵ LHS ֵѹ
 	*/
 	stack<SemVal> ValueStack;
@@ -246,6 +249,51 @@ struct ShiftReduceParser
 	*/
 	stack<int> PendingIfElseEndJumps;
 
+	/*
+	SemIds嶯õķűţʱֽһΣʱֻȽ
+	- սΪ ACTION кţսΪ GOTO кţķûеķΪ -1
+	- ʽҲͳһţ SLRAnalysisTableBuilder::ProductionRightսͳһż
+	*/
+	struct SemIds
+	{
+		int Id = -1, Num = -1, If = -1, Else = -1, Int = -1, Void = -1;
+		int LParen = -1, RParen = -1, LBrace = -1, RBrace = -1;
+		int Mul = -1, Div = -1, Add = -1, Sub = -1;
+		vector<bool> IsRelOp; // սţ< > <= >= == !=
+
+		int Type = -1, Parameter = -1, Factor = -1, Term = -1, Expr = -1, RelOp = -1, RelExpr = -1;
+		int DeclarationStatement = -1, AssignmentStatement = -1, ExprStatement = -1, ReturnStatement = -1;
+		int Stmt = -1, StmtList = -1, CompoundStatement = -1, SelectionStatement = -1, IterationStatement = -1;
+	} Ids;
+
+	void ResolveSemIds()
+	{
+		auto T = [&](const char* name) { return TableBuilder.TerminalIdOf(name); };
+		auto N = [&](const char* name) { return TableBuilder.NonTerminalIdOf(name); };
+
+		Ids.Id = T("id"); Ids.Num = T("num"); Ids.If = T("if"); Ids.Else = T("else");
+		Ids.Int = T("int"); Ids.Void = T("void");
+		Ids.LParen = T("("); Ids.RParen = T(")"); Ids.LBrace = T("{"); Ids.RBrace = T("}");
+		Ids.Mul = T("*"); Ids.Div = T("/"); Ids.Add = T("+"); Ids.Sub = T("-");
+		Ids.IsRelOp.assign(TableBuilder.TerminalNames.size(), false);
+		for (const char* op : { "<", ">", "<=", ">=", "==", "!=" }) {
+			if (T(op) != -1) Ids.IsRelOp[T(op)] = true;
+		}
+
+		Ids.Type = N("Type"); Ids.Parameter = N("Parameter"); Ids.Factor = N("Factor");
+		Ids.Term = N("Term"); Ids.Expr = N("Expr"); Ids.RelOp = N("RelOp"); Ids.RelExpr = N("RelExpr");
+		Ids.DeclarationStatement = N("DeclarationStatement"); Ids.AssignmentStatement = N("AssignmentStatement");
+		Ids.ExprStatement = N("ExprStatement"); Ids.ReturnStatement = N("ReturnStatement");
+		Ids.Stmt = N("Stmt"); Ids.StmtList = N("StmtList"); Ids.CompoundStatement = N("CompoundStatement");
+		Ids.SelectionStatement = N("SelectionStatement"); Ids.IterationStatement = N("IterationStatement");
+	}
+
+	// ջеķǷΪŵս / ս
+	static bool IsSymbol(const GrammarSymbol& s, bool isTerminal, int id)
+	{
+		return id != -1 && s.IsTerminal == isTerminal && s.Id == id;
+	}
+
 	// ӡ IR
 	void DumpIR() const {
 		cout << "\n==== IR quads ====\n";
@@ -287,19 +335,36 @@ struct ShiftReduceParser
 	stack<int> StateStack;			  // ״̬ջ
 	stack<GrammarSymbol> SymbolStack; // ջ
 
+	LineIndex Lines; //  token  SourceLoc Ϊк
+
+	// λøʽΪ "(,)"ڱʱ
+	string FormatLoc(SourceLoc loc) const
+	{
+		LineCol lc = Lines.resolve(loc.offset);
+		return "(" + to_string(lc.line) + "," + to_string(lc.column) + ")";
+	}
+
 	// ݲʽIDȡʽ
 	const Production& GetProductionById(int prodId) const
 	{
-		for (const auto& prod : Grammar.Productions)
+		const vector<int>& Index = TableBuilder.ProductionIndex;
+		if (prodId >= 0 && prodId < (int)Index.size() && Index[prodId] != -1)
 		{
-			if (prod.Id == prodId)
-			{
-				return prod;
-			}
+			return Grammar.Productions[Index[prodId]];
 		}
 		throw runtime_error("δҵIDΪ" + to_string(prodId) + "Ĳʽ");
 	}
 
+	// ջзŵʾѱŵķȡķе֣ x ʾΪ id
+	const string& StackName(const GrammarSymbol& Symbol) const
+	{
+		if (Symbol.Id == -1)
+		{
+			return Symbol.Name;
+		}
+		return Symbol.IsTerminal ? TableBuilder.TerminalNames[Symbol.Id] : TableBuilder.NonTerminalNames[Symbol.Id];
+	}
+
 	// ӡǰջ״̬
 	void PrintStacks() const
 	{
@@ -329,7 +394,7 @@ struct ShiftReduceParser
 		}
 		for (auto It = Symbols.rbegin(); It != Symbols.rend(); ++It)
 		{
-			cout << It->Name;
+			cout << StackName(*It);
 			if (!It->TokenType.empty())
 			{
 				cout << "(" << It->TokenType << ")";
@@ -345,9 +410,11 @@ struct ShiftReduceParser
 	{
 		// ʼ״̬ջͷջ
 		StateStack.push(0);							// ʼ״̬Ϊ0
-		SymbolStack.push(GrammarSymbol("$", true)); // ջ׷Ϊ$
+		SymbolStack.push(GrammarSymbol("$", true, "", SourceLoc(), TableBuilder.EndTerminal)); // ջ׷Ϊ$
 
 #ifdef SEM_IR
+		ResolveSemIds();
+
 		// ֵջջϸ룺
 		// - ջѾѹ "$"
 		// - ֵջҲѹһ monostate ռλ "$" 
@@ -361,32 +428,43 @@ struct ShiftReduceParser
 
 	// շУǷɹ
 	bool Parse(const vector<GrammarSymbol>& inputSymbols)
+	{
+		size_t InputIndex = 0;
+		return Parse([&](GrammarSymbol& Next) {
+			if (InputIndex >= inputSymbols.size())
+			{
+				return false;
+			}
+			Next = inputSymbols[InputIndex++];
+			return true;
+		});
+	}
+
+	// ȡʽҪһʱ NextToken ȡһ token
+	// NextToken  false ʾ֮һΪ $
+	// ʷԱ߲߱ѣռ token 
+	// ȡ token  Id аսţ SLRAnalysisTableBuilder::BindTokenKinds
+	// ֻId Ϊ -1  token ûжӦս﷨
+	bool Parse(const function<bool(GrammarSymbol&)>& NextToken)
 	{
 		cout << "ʼƽ-Լ\n";
 
-		size_t InputIndex = 0;
 		const GrammarSymbol& EndSymbol = TableBuilder.FFCalculator.EndSymbol;
+		GrammarSymbol Lookahead;
+		bool HasInput = NextToken(Lookahead);
 
 		while (true)
 		{
 			// ȡǰ״̬͵ǰ
 			int CurrentState = StateStack.top();
-			const GrammarSymbol& CurrentInput = (InputIndex < inputSymbols.size()) ? inputSymbols[InputIndex] : EndSymbol;
-
-			// IDNUM
-			GrammarSymbol LookupSymbol = CurrentInput;
-			if (CurrentInput.TokenType == "ID") {
-				LookupSymbol.Name = "id";
-			}
-			else if (CurrentInput.TokenType == "NUM") {
-				LookupSymbol.Name = "num";
-			}
+			const GrammarSymbol& CurrentInput = HasInput ? Lookahead : EndSymbol;
+			int Terminal = HasInput ? Lookahead.Id : TableBuilder.EndTerminal;
 
 			cout << "\nǰ״̬: " << CurrentState << ", ǰ: " << CurrentInput.Name << "\n";
 			PrintStacks();
 
 			// ACTION
-			const SLRAction& Action = TableBuilder.GetAction(CurrentState, LookupSymbol);
+			const SLRAction& Action = TableBuilder.GetAction(CurrentState, Terminal);
 
 			if (Action.Type == SLRActionType::SHIFT)
 			{
@@ -404,7 +482,7 @@ struct ShiftReduceParser
 				  2) backpatch 浽 then.begin
 				  3) backpatch ٵ else.begin˿ NextQuad()  else һĵַ
 				*/
-				if (CurrentInput.Name == "else") {
+				if (Terminal == Ids.Else) {
 					// Ʒջ/ջ飬ģʽƥ䶨λ if (RelExpr) Stmt
 					// ǡС hackʽ idջ̬м
 					auto CopySyms = SymbolStack; vector<GrammarSymbol> syms;
@@ -417,7 +495,7 @@ struct ShiftReduceParser
 					// һ "if ( RelExpr ) Stmt" ģʽ
 					int idx = -1;
 					for (int i = (int)syms.size() - 5; i >= 0; --i) {
-						if (syms[i].Name == "if" && syms[i + 1].Name == "(" && syms[i + 2].Name == "RelExpr" && syms[i + 3].Name == ")" && syms[i + 4].Name == "Stmt") {
+						if (IsSymbol(syms[i], true, Ids.If) && IsSymbol(syms[i + 1], true, Ids.LParen) && IsSymbol(syms[i + 2], false, Ids.RelExpr) && IsSymbol(syms[i + 3], true, Ids.RParen) && IsSymbol(syms[i + 4], false, Ids.Stmt)) {
 							idx = i; break;
 						}
 					}
@@ -449,7 +527,7 @@ struct ShiftReduceParser
 				ע⣺
 				-  Scopes.size()==1 Ϊȫֲ㡱ʶоֲ '('﷨չָ/õȻӣ
 				*/
-				if (CurrentInput.Name == "(") {
+				if (Terminal == Ids.LParen) {
 					auto tmpSym = SymbolStack; auto tmpVal = ValueStack;
 					GrammarSymbol s1 = tmpSym.top(); tmpSym.pop(); // ջţƽǰһţ
 					GrammarSymbol s2 = tmpSym.top(); // s1 ·
@@ -457,7 +535,7 @@ struct ShiftReduceParser
 					SemVal v1 = tmpVal.top(); tmpVal.pop();
 					SemVal v2 = tmpVal.top();
 
-					if (s1.Name == "id" && s2.Name == "Type" && Is<IdVal>(v1) && Is<TypeVal>(v2) && Scopes.size() == 1) {
+					if (IsSymbol(s1, true, Ids.Id) && IsSymbol(s2, false, Ids.Type) && Is<IdVal>(v1) && Is<TypeVal>(v2) && Scopes.size() == 1) {
 						auto idv = As<IdVal>(v1);
 						auto tv = As<TypeVal>(v2);
 
@@ -466,7 +544,7 @@ struct ShiftReduceParser
 
 						// ͬһض飺ͬظֱӱ
 						if (!InsertHere(idv.name, fs, err)) {
-							cout << ": " << err << " @ " << idv.pos << "\n";
+							cout << ": " << err << " @ " << FormatLoc(idv.pos) << "\n";
 							return false;
 						}
 						// 롰ġԼ Parameter ʱۼƵ PendingParams
@@ -477,37 +555,47 @@ struct ShiftReduceParser
 				}
 #endif
 				
-				// ƽķź״̬
-				SymbolStack.push(LookupSymbol);
-				StateStack.push(Action.StateOrProduction);
-
 #ifdef SEM_IR
 				/*
-				(3) ֵջ SymbolStack  SHIFT 뱣ͬ롣
+				(3) ֵ SymbolStack  SHIFT 뱣ͬ롣
 				ؼ㣺
-				- ﷨ڲ ACTION  LookupSymbolID/NUM ͳһ "id"/"num"
+				- ջֻսʹţID/NUM ӡΪ "id"/"num"
 				- Ҫԭʼ lexeme "x" "123"
-				ˣֵջʹ CurrentInputԭʼ token LookupSymbol
+				ˣֵƽ֮ǰ CurrentInputԭʼ tokenƽ֮ջ
 				*/
 				SemVal pushed = monostate{};
-				if (CurrentInput.TokenType == "ID") {
-					pushed = IdVal{ CurrentInput.Name,CurrentInput.Position };
+				if (Terminal == Ids.Id) {
+					pushed = IdVal{ CurrentInput.Name,CurrentInput.Loc };
 				}
-				else if (CurrentInput.TokenType == "NUM") {
+				else if (Terminal == Ids.Num) {
 					int x = 0; try { x = stoi(CurrentInput.Name); }
 					catch (...) { x = 0; }
 					pushed = NumVal{ x };
 				}
-				else if (CurrentInput.Name == "int") {
+				else if (Terminal == Ids.Int) {
 					pushed = TypeVal{ BaseType::INT };
 				}
-				else if (CurrentInput.Name == "void") {
+				else if (Terminal == Ids.Void) {
 					pushed = TypeVal{ BaseType::VOID };
 				}
-				else if (CurrentInput.Name == "<" || CurrentInput.Name == ">" || CurrentInput.Name == "<=" || CurrentInput.Name == ">=" || CurrentInput.Name == "==" || CurrentInput.Name == "!=") {
+				else if (Ids.IsRelOp[Terminal]) {
 					// ϵΪ OpVal 棬ڹԼ RelExpr ʱ if< / if== ת
 					pushed = OpVal{ CurrentInput.Name };
 				}
+#endif
+
+				// ƽź״ֱ̬ջٸ
+				if (HasInput)
+				{
+					SymbolStack.push(std::move(Lookahead));
+				}
+				else
+				{
+					SymbolStack.push(EndSymbol);
+				}
+				StateStack.push(Action.StateOrProduction);
+
+#ifdef SEM_IR
 				ValueStack.push(pushed);
 
 				/*
@@ -519,7 +607,7 @@ struct ShiftReduceParser
 				  ѡڽ뺯 '{' ʱ PendingParams 뵽½Уں
 				- FuncScopeDepth жϺ EndScope  Scopes.size() < FuncScopeDepth Ϊ
 				*/
-				if (CurrentInput.Name == "{") {
+				if (Terminal == Ids.LBrace) {
 					BeginScope();
 					// ս뺯壺Ѳ뵽
 					if (PendingFunc) {
@@ -538,7 +626,7 @@ struct ShiftReduceParser
 						PendingFunc = false;
 					}
 				}
-				else if (CurrentInput.Name == "}") {
+				else if (Terminal == Ids.RBrace) {
 					EndScope();
 					// 򵯳˺֮⣬˵պ
 					if (InFunction && (int)Scopes.size() < FuncScopeDepth) {
@@ -549,9 +637,9 @@ struct ShiftReduceParser
 #endif
 
 				// ƶһ
-				if (CurrentInput != EndSymbol)
+				if (HasInput)
 				{
-					InputIndex++;
+					HasInput = NextToken(Lookahead);
 				}
 			}
 			else if (Action.Type == SLRActionType::REDUCE)
@@ -559,10 +647,11 @@ struct ShiftReduceParser
 				cout << "ִйԼ: R" << Action.StateOrProduction << "\n";
 				// ݲʽIDȡʽ
 				const Production& Prod = GetProductionById(Action.StateOrProduction);
+				const int Left = TableBuilder.ProductionLeft[Action.StateOrProduction];
 				cout << "ʹòʽ: " << Prod.ToString() << "\n";
 
 				// ķĿʼʽProgram' -> Program
-				if (Prod.Left.Name == Grammar.StartSymbol.Name)
+				if (Left == TableBuilder.StartNonTerminal)
 				{
 					cout << "\nɹͨʽ\n";
 #ifdef SEM_IR
@@ -608,42 +697,44 @@ struct ShiftReduceParser
 				*/
 				SemVal lhsVal = monostate{};
 
-				auto& L = Prod.Left.Name;
+				//  / Ҳűŷɣ SemIds
+				const int L = Left;
+				const vector<int>& R = TableBuilder.ProductionRight[Action.StateOrProduction];
 
 				// ---- Type -> int/void ֱ͸shift ѹ TypeVal :contentReference[oaicite:4]{index=4}
-				if (L == "Type") {
+				if (L == Ids.Type) {
 					if (Is<TypeVal>(rhs[0])) lhsVal = rhs[0];
-					else if (Prod.Right[0].Name == "int") lhsVal = TypeVal{ BaseType::INT };
-					else if (Prod.Right[0].Name == "void") lhsVal = TypeVal{ BaseType::VOID };
+					else if (R[0] == Ids.Int) lhsVal = TypeVal{ BaseType::INT };
+					else if (R[0] == Ids.Void) lhsVal = TypeVal{ BaseType::VOID };
 				}
 
 				// ---- Parameter -> Type idѲȼǵ PendingParams '{' :contentReference[oaicite:5]{index=5}
-				else if (L == "Parameter") {
+				else if (L == Ids.Parameter) {
 					auto tv = As<TypeVal>(rhs[0]);
 					auto idv = As<IdVal>(rhs[1]);
-					if (tv.t == BaseType::VOID) { cout << ":  void: " << idv.name << " @ " << idv.pos << "\n"; return false; }
+					if (tv.t == BaseType::VOID) { cout << ":  void: " << idv.name << " @ " << FormatLoc(idv.pos) << "\n"; return false; }
 					PendingParams.push_back({ idv.name,tv.t });
 					lhsVal = monostate{};
 				}
 
 				// ---- Factor -> id/num/(Expr) :contentReference[oaicite:6]{index=6}
-				else if (L == "Factor" && n == 1 && Prod.Right[0].Name == "id") {
+				else if (L == Ids.Factor && n == 1 && R[0] == Ids.Id) {
 					auto idv = As<IdVal>(rhs[0]);
 					auto* sym = Lookup(idv.name);
-					if (!sym) { cout << ": ʹδʶ " << idv.name << " @ " << idv.pos << "\n"; return false; }
-					if (sym->kind == SymKind::FUNC) { cout << ": ҪǺ " << idv.name << " @ " << idv.pos << "\n"; return false; }
+					if (!sym) { cout << ": ʹδʶ " << idv.name << " @ " << FormatLoc(idv.pos) << "\n"; return false; }
+					if (sym->kind == SymKind::FUNC) { cout << ": ҪǺ " << idv.name << " @ " << FormatLoc(idv.pos) << "\n"; return false; }
 					lhsVal = ExprVal{ sym->type,sym->irName,-1 };
 				}
-				else if (L == "Factor" && n == 1 && Prod.Right[0].Name == "num") {
+				else if (L == Ids.Factor && n == 1 && R[0] == Ids.Num) {
 					auto nv = As<NumVal>(rhs[0]);
 					lhsVal = ExprVal{ BaseType::INT,to_string(nv.v),-1 };
 				}
-				else if (L == "Factor" && n == 3 && Prod.Right[0].Name == "(") {
+				else if (L == Ids.Factor && n == 3 && R[0] == Ids.LParen) {
 					lhsVal = rhs[1]; // ( Expr )
 				}
 
 				// ---- Term / Exprͼ + ʱ IR :contentReference[oaicite:7]{index=7}
-				else if (L == "Term" && n == 3 && (Prod.Right[1].Name == "*" || Prod.Right[1].Name == "/")) {
+				else if (L == Ids.Term && n == 3 && (R[1] == Ids.Mul || R[1] == Ids.Div)) {
 					auto a = As<ExprVal>(rhs[0]), b = As<ExprVal>(rhs[2]);
 					if (a.t != BaseType::INT || b.t != BaseType::INT) { cout << ": ˳ֻ֧ int\n"; return false; }
 					string t = NewTemp();
@@ -651,10 +742,10 @@ struct ShiftReduceParser
 					int bg = (a.begin != -1) ? a.begin : idx;
 					lhsVal = ExprVal{ BaseType::INT,t,bg };
 				}
-				else if (L == "Term" && n == 1) {
+				else if (L == Ids.Term && n == 1) {
 					lhsVal = rhs[0];
 				}
-				else if (L == "Expr" && n == 3 && (Prod.Right[1].Name == "+" || Prod.Right[1].Name == "-")) {
+				else if (L == Ids.Expr && n == 3 && (R[1] == Ids.Add || R[1] == Ids.Sub)) {
 					auto a = As<ExprVal>(rhs[0]), b = As<ExprVal>(rhs[2]);
 					if (a.t != BaseType::INT || b.t != BaseType::INT) { cout << ": Ӽֻ֧ int\n"; return false; }
 					string t = NewTemp();
@@ -662,17 +753,17 @@ struct ShiftReduceParser
 					int bg = (a.begin != -1) ? a.begin : idx;
 					lhsVal = ExprVal{ BaseType::INT,t,bg };
 				}
-				else if (L == "Expr" && n == 1) {
+				else if (L == Ids.Expr && n == 1) {
 					lhsVal = rhs[0];
 				}
 
 				// ---- RelOpѲַ OpVal :contentReference[oaicite:8]{index=8}
-				else if (L == "RelOp" && n == 1) {
+				else if (L == Ids.RelOp && n == 1) {
 					lhsVal = OpVal{ Prod.Right[0].Name };
 				}
 
 				// ---- RelExpr if-goto / goto ռλ :contentReference[oaicite:9]{index=9}
-				else if (L == "RelExpr" && n == 3) {
+				else if (L == Ids.RelExpr && n == 3) {
 					auto a = As<ExprVal>(rhs[0]);
 					auto op = As<OpVal>(rhs[1]).op;
 					auto b = As<ExprVal>(rhs[2]);
@@ -681,7 +772,7 @@ struct ShiftReduceParser
 					int j = Emit("goto", "", "", "", -1);
 					lhsVal = BoolVal{ {i},{j},i };
 				}
-				else if (L == "RelExpr" && n == 1) {
+				else if (L == Ids.RelExpr && n == 1) {
 					auto a = As<ExprVal>(rhs[0]);
 					if (a.t != BaseType::INT) { cout << ": ʽҪ int(Ϊ)\n"; return false; }
 					int i = Emit("ifnz", a.place, "", "", -1);
@@ -690,14 +781,14 @@ struct ShiftReduceParser
 				}
 
 				// ---- DeclarationStatementű + ѡʼֵ :contentReference[oaicite:10]{index=10}
-				else if (L == "DeclarationStatement" && (n == 3 || n == 5)) {
+				else if (L == Ids.DeclarationStatement && (n == 3 || n == 5)) {
 					auto tv = As<TypeVal>(rhs[0]);
 					auto idv = As<IdVal>(rhs[1]);
-					if (tv.t == BaseType::VOID) { cout << ":  void: " << idv.name << " @ " << idv.pos << "\n"; return false; }
+					if (tv.t == BaseType::VOID) { cout << ":  void: " << idv.name << " @ " << FormatLoc(idv.pos) << "\n"; return false; }
 
 					Symbol vs; vs.kind = SymKind::VAR; vs.type = tv.t; vs.irName = NewVarName(idv.name); vs.scopeLevel = (int)Scopes.size() - 1;
 					string err;
-					if (!InsertHere(idv.name, vs, err)) { cout << ": " << err << " @ " << idv.pos << "\n"; return false; }
+					if (!InsertHere(idv.name, vs, err)) { cout << ": " << err << " @ " << FormatLoc(idv.pos) << "\n"; return false; }
 
 					int bg = NextQuad();
 					if (n == 5) {
@@ -710,10 +801,10 @@ struct ShiftReduceParser
 				}
 
 				// ---- AssignmentStatementδ/ͼ + ɸֵ IR :contentReference[oaicite:11]{index=11}
-				else if (L == "AssignmentStatement" && n == 4) {
+				else if (L == Ids.AssignmentStatement && n == 4) {
 					auto idv = As<IdVal>(rhs[0]);
 					auto* sym = Lookup(idv.name);
-					if (!sym) { cout << ": ֵδʶ " << idv.name << " @ " << idv.pos << "\n"; return false; }
+					if (!sym) { cout << ": ֵδʶ " << idv.name << " @ " << FormatLoc(idv.pos) << "\n"; return false; }
 					if (sym->kind == SymKind::FUNC) { cout << ": ֵܸ " << idv.name << "\n"; return false; }
 					auto e = As<ExprVal>(rhs[2]);
 					if (e.t != sym->type) { cout << ": ֵͲƥ " << idv.name << "\n"; return false; }
@@ -723,16 +814,16 @@ struct ShiftReduceParser
 				}
 
 				// ---- ExprStatementExpr ;  ; :contentReference[oaicite:12]{index=12}
-				else if (L == "ExprStatement" && n == 2) {
+				else if (L == Ids.ExprStatement && n == 2) {
 					auto e = As<ExprVal>(rhs[0]);
 					lhsVal = StmtVal{ {}, e.begin != -1 ? e.begin : NextQuad() };
 				}
-				else if (L == "ExprStatement" && n == 1) {
+				else if (L == Ids.ExprStatement && n == 1) {
 					lhsVal = StmtVal{ {}, NextQuad() };
 				}
 
 				// ---- ReturnStatementreturn/return Expr ͼ + emit return :contentReference[oaicite:13]{index=13}
-				else if (L == "ReturnStatement" && (n == 2 || n == 3)) {
+				else if (L == Ids.ReturnStatement && (n == 2 || n == 3)) {
 					if (!InFunction) { cout << ": return ֻܳں\n"; return false; }
 					int idx = NextQuad();
 					if (n == 2) {
@@ -748,13 +839,13 @@ struct ShiftReduceParser
 				}
 
 				// ---- Stmt / StmtList˳ʱ nextlist :contentReference[oaicite:14]{index=14}
-				else if (L == "Stmt") {
+				else if (L == Ids.Stmt) {
 					lhsVal = rhs[0]; // ֱ͸
 				}
-				else if (L == "StmtList" && n == 1) {
+				else if (L == Ids.StmtList && n == 1) {
 					lhsVal = rhs[0];
 				}
-				else if (L == "StmtList" && n == 2) {
+				else if (L == Ids.StmtList && n == 2) {
 					auto s1 = As<StmtVal>(rhs[0]);
 					auto s2 = As<StmtVal>(rhs[1]);
 					// s1 ġ nextlistӵ s2 ʼ
@@ -764,15 +855,15 @@ struct ShiftReduceParser
 				}
 
 				// ---- CompoundStatement{ }  { StmtList } :contentReference[oaicite:15]{index=15}
-				else if (L == "CompoundStatement" && n == 2) {
+				else if (L == Ids.CompoundStatement && n == 2) {
 					lhsVal = StmtVal{ {},NextQuad() };
 				}
-				else if (L == "CompoundStatement" && n == 3) {
+				else if (L == Ids.CompoundStatement && n == 3) {
 					lhsVal = rhs[1];
 				}
 
 				// ---- SelectionStatementif/if-elseif-else м goto  shift else ˣ :contentReference[oaicite:16]{index=16}
-				else if (L == "SelectionStatement" && n == 5) {
+				else if (L == Ids.SelectionStatement && n == 5) {
 					auto B = As<BoolVal>(rhs[2]);
 					auto S = As<StmtVal>(rhs[4]);
 					Backpatch(B.truelist, S.begin == -1 ? NextQuad() : S.begin);
@@ -780,7 +871,7 @@ struct ShiftReduceParser
 					Backpatch(S.nextlist, NextQuad());
 					lhsVal = StmtVal{ {},B.begin };
 				}
-				else if (L == "SelectionStatement" && n == 7) {
+				else if (L == Ids.SelectionStatement && n == 7) {
 					// if (B) S1 else S2endJump  shift else ʱ emitֻ else ֮
 					auto B = As<BoolVal>(rhs[2]);
 					auto S1 = As<StmtVal>(rhs[4]);
@@ -796,7 +887,7 @@ struct ShiftReduceParser
 				}
 
 				// ---- IterationStatementwhile (B) S :contentReference[oaicite:17]{index=17}
-				else if (L == "IterationStatement" && n == 5) {
+				else if (L == Ids.IterationStatement && n == 5) {
 					auto B = As<BoolVal>(rhs[2]);
 					auto S = As<StmtVal>(rhs[4]);
 					Backpatch(B.truelist, S.begin == -1 ? NextQuad() : S.begin);
@@ -818,11 +909,11 @@ struct ShiftReduceParser
 				// ȡԼĵǰ״̬
 				int AfterReduceState = StateStack.top();
 
-				// ѹʽ󲿷
-				SymbolStack.push(Prod.Left);
+				// ѹʽ󲿷ţֻǷսţӡʱȡ֣
+				SymbolStack.push(GrammarSymbol("", false, "", SourceLoc(), Left));
 
 				// GOTOȡ״̬
-				int GotoState = TableBuilder.GetGoto(AfterReduceState, Prod.Left);
+				int GotoState = TableBuilder.GetGoto(AfterReduceState, Left);
 				if (GotoState == -1)
 				{
 					cout << "״̬" << AfterReduceState << "Էս" << Prod.Left.Name << "GOTOδҵ\n";
@@ -873,18 +964,61 @@ struct ShiftReduceParser
 	}
 
 	// ӴʷļжȡtokensתΪGrammarSymbol
+	// ıʽе "(,)" ԭΪȼ۵ֽƫƣͬؽ Lines
+	// ÿµһоһ token ֮һУ
+	// ʹ Lines.resolve(offset) ǡõõԭк
 	vector<GrammarSymbol> LoadTokensFromFile(const string& tokenFile)
 	{
 		vector<GrammarSymbol> Tokens;
 		ifstream File(tokenFile);
 		string Line;
 
+		Lines = LineIndex();
+		int CurLine = 1;		// ǰ
+		uint32_t LineStart = 0; // ǰƫ
+		uint32_t Cursor = 0;	// ѷ token Զƫ
+
+		// "(,)" -> SourceLoc
+		auto ToLoc = [&](const string& position, size_t length) {
+			int L = 0, C = 0;
+			char LParen = 0, Comma = 0;
+			istringstream Ps(position);
+			if (!(Ps >> LParen >> L >> Comma >> C) || LParen != '(' || Comma != ',' || L < 1 || C < 1)
+			{
+				return SourceLoc();
+			}
+			for (; CurLine < L; ++CurLine)
+			{
+				Lines.addNewline(Cursor);
+				LineStart = Cursor + 1;
+				Cursor = LineStart;
+			}
+			SourceLoc Loc;
+			Loc.offset = LineStart + (uint32_t)(C - 1);
+			Cursor = max(Cursor, Loc.offset + (uint32_t)length);
+			return Loc;
+		};
+
 		if (!File.is_open())
 		{
 			cerr << "޷򿪴ʷļ: " << tokenFile << endl;
 			return Tokens;
 		}
 
+		//  Token lexer_gen --format=binaryӳļ󰴶¼ȡ
+		char Magic[sizeof(TOKEN_STREAM_MAGIC)] = {};
+		File.read(Magic, sizeof(Magic));
+		if (TokenStreamView::isTokenStream(string_view(Magic, (size_t)File.gcount())))
+		{
+			File.close();
+			return LoadTokensFromStream(tokenFile);
+		}
+		File.clear();
+		File.seekg(0);
+
+		// սڶʱÿֻһΣ󶨲ʱٰ token ı
+		map<string, int> TypeTerminals;
+
 		while (getline(File, Line))
 		{
 			istringstream Iss(Line);
@@ -905,7 +1039,13 @@ struct ShiftReduceParser
 				{
 					Iss >> Position;
 
-					Tokens.push_back(GrammarSymbol(TokenValue, true, TokenTypeStr, Position));
+					auto Found = TypeTerminals.find(TokenTypeStr);
+					if (Found == TypeTerminals.end())
+					{
+						Found = TypeTerminals.emplace(TokenTypeStr, TableBuilder.ResolveTerminal(TokenTypeStr, "")).first;
+					}
+					int Terminal = Found->second != -1 ? Found->second : TableBuilder.TerminalIdOf(TokenValue);
+					Tokens.push_back(GrammarSymbol(TokenValue, true, TokenTypeStr, ToLoc(Position, TokenValue.size()), Terminal));
 				}
 			}
 		}
@@ -914,6 +1054,58 @@ struct ShiftReduceParser
 		return Tokens;
 	}
 
+	// ȡ Token нı
+	// - ͱֻһ
+	// - λֱȡֽƫƣLines ļеĻбؽ
+	vector<GrammarSymbol> LoadTokensFromStream(const string& tokenFile)
+	{
+		vector<GrammarSymbol> Tokens;
+		SourceFile File(tokenFile);
+		TokenStreamView Stream;
+
+		if (!Stream.open(File.view()))
+		{
+			cerr << "ʷļʽ: " << tokenFile << endl;
+			return Tokens;
+		}
+
+		Lines = LineIndex();
+		for (uint32_t k = 0; k < Stream.header->newlineCount; ++k)
+		{
+			Lines.addNewline(Stream.newlines[k]);
+		}
+
+		// 밴󶨵սŶֻһ
+		vector<string> TypeNames;
+		vector<int> TypeTerminals;
+		for (uint32_t k = 0; k < Stream.header->typeCount; ++k)
+		{
+			TypeNames.emplace_back(Stream.typeName(k));
+			TypeTerminals.push_back(TableBuilder.ResolveTerminal(TypeNames.back(), ""));
+		}
+
+		Tokens.reserve(Stream.size());
+		for (uint32_t k = 0; k < Stream.size(); ++k)
+		{
+			const TokenRecord& Record = Stream.records[k];
+
+			// ıʽһ£û lexeme ļ¼ENDFILE
+			if (Record.length == 0)
+			{
+				continue;
+			}
+
+			SourceLoc Loc;
+			Loc.offset = Record.offset;
+			Loc.fileId = Stream.header->fileId;
+			string Lexeme(Stream.lexeme(Record));
+			int Terminal = TypeTerminals[Record.type] != -1 ? TypeTerminals[Record.type] : TableBuilder.TerminalIdOf(Lexeme);
+			Tokens.push_back(GrammarSymbol(Lexeme, true, TypeNames[Record.type], Loc, Terminal));
+		}
+
+		return Tokens;
+	}
+
 };
 
 #endif // SHIFTREDUCEPARSER_HPP